@@ -0,0 +1,33 @@
+#include "alloc_counter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Kept in its own translation unit so the replaced operators are never
+// inlined next to their callers (GCC then reports bogus new/free mismatches)
+
+namespace {
+    std::atomic<uint64_t> g_alloc_count{0};
+    std::atomic<uint64_t> g_alloc_bytes{0};
+}
+
+namespace lazyjson_bench {
+
+    uint64_t allocationCount() { return g_alloc_count.load(std::memory_order_relaxed); }
+    uint64_t allocatedBytes() { return g_alloc_bytes.load(std::memory_order_relaxed); }
+
+} // namespace lazyjson_bench
+
+void* operator new(std::size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
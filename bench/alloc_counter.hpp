@@ -0,0 +1,16 @@
+#ifndef LAZYJSON_BENCH_ALLOC_COUNTER_HPP
+#define LAZYJSON_BENCH_ALLOC_COUNTER_HPP
+
+#include <cstdint>
+
+namespace lazyjson_bench {
+
+    // Totals maintained by the replaced global operator new (alloc_counter.cpp).
+    // The replacement also covers the allocations made inside liblazyjson,
+    // so every phase can report how many heap allocations it triggered.
+    uint64_t allocationCount();
+    uint64_t allocatedBytes();
+
+} // namespace lazyjson_bench
+
+#endif // LAZYJSON_BENCH_ALLOC_COUNTER_HPP
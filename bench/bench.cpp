@@ -0,0 +1,701 @@
+#include "alloc_counter.hpp"
+#include "corpus.hpp"
+#include "perf_counters.hpp"
+#include "parser.hpp"
+#include "format.hpp"
+#include "parser_pool.hpp"
+#include "sharded_cache.hpp"
+#include "tokenizer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef LAZYJSON_BENCH_WITH_NLOHMANN
+#include "nlohmann/json.hpp"
+#endif
+
+#ifdef LAZYJSON_BENCH_WITH_RAPIDJSON
+#include <rapidjson/document.h>
+#include <rapidjson/pointer.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#endif
+
+namespace lazyjson_bench {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        size_t iterations = 20;
+        size_t warmup = 2;
+        double scale = 1.0;
+        uint64_t seed = 42;
+        std::vector<std::string> corpora;
+        std::vector<std::string> libraries;
+        bool perf = false;
+        // > 0: run the concurrency benchmark with this many threads instead of the phases
+        size_t threads = 0;
+        // Run the ShardedCache benchmark instead of the corpora
+        bool cache = false;
+        // > 0: run the large document benchmark on a generated file of this many GB
+        double large = 0;
+        std::string large_path = "lazyjson_large.json";
+    };
+
+    // Hardware counters, only set when --perf is given and at least one event could be opened
+    PerfCounters* g_perf = nullptr;
+
+    struct AllocSnapshot {
+        uint64_t count = allocationCount();
+        uint64_t bytes = allocatedBytes();
+    };
+
+    // Samples collected for one (library, corpus, phase) triple
+    struct PhaseSamples {
+        std::vector<int64_t> ns;
+        uint64_t allocations = 0;
+        uint64_t allocated_bytes = 0;
+        PerfReading perf;
+    };
+
+    // Measure one phase and account time and allocations into `samples`
+    template<typename Fn>
+    void measure(PhaseSamples& samples, bool record, Fn&& fn) {
+        AllocSnapshot before;
+        if (g_perf) g_perf->start();
+        auto start = Clock::now();
+        fn();
+        auto end = Clock::now();
+        PerfReading perf = g_perf ? g_perf->stop() : PerfReading{};
+        AllocSnapshot after;
+        if (!record) return;
+        samples.perf += perf;
+        samples.ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        samples.allocations += after.count - before.count;
+        samples.allocated_bytes += after.bytes - before.bytes;
+    }
+
+    int64_t percentile(const std::vector<int64_t>& sorted, double p) {
+        if (sorted.empty()) return 0;
+        size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    // Hardware counters averaged per iteration, plus per byte and per token ratios.
+    // The token count is the one produced by the lazyjson tokenizer for the corpus,
+    // used as a common normalizer for every library.
+    std::string perfFields(const PhaseSamples& samples, size_t bytes, size_t tokens) {
+        std::string fields;
+        const double runs = static_cast<double>(samples.ns.size());
+        char buffer[160];
+        for (size_t i = 0; i < kPerfEventCount; i++) {
+            const auto event = static_cast<PerfEvent>(i);
+            if (!samples.perf.has(event)) continue;
+            const double value = static_cast<double>(samples.perf.get(event)) / runs;
+            std::snprintf(buffer, sizeof(buffer), ",\"%s\":%.1f,\"%s_per_byte\":%.4f,\"%s_per_token\":%.4f",
+                          PerfCounters::eventName(event), value,
+                          PerfCounters::eventName(event), bytes ? value / static_cast<double>(bytes) : 0.0,
+                          PerfCounters::eventName(event), tokens ? value / static_cast<double>(tokens) : 0.0);
+            fields.append(buffer);
+        }
+        if (samples.perf.has(PerfEvent::CYCLES) && samples.perf.has(PerfEvent::INSTRUCTIONS) && samples.perf.get(PerfEvent::CYCLES)) {
+            std::snprintf(buffer, sizeof(buffer), ",\"ipc\":%.3f",
+                          static_cast<double>(samples.perf.get(PerfEvent::INSTRUCTIONS)) / static_cast<double>(samples.perf.get(PerfEvent::CYCLES)));
+            fields.append(buffer);
+        }
+        return fields;
+    }
+
+    // One JSON object per line, so results can be piped straight into jq or a dataframe
+    void report(const Options& options, const std::string& library, const Corpus& corpus,
+                const char* phase, size_t bytes, size_t tokens, size_t operations, PhaseSamples& samples,
+                const std::string& extra = "") {
+        if (samples.ns.empty()) return;
+        std::vector<int64_t> sorted = samples.ns;
+        std::sort(sorted.begin(), sorted.end());
+        double mean = 0;
+        for (auto ns : sorted) mean += static_cast<double>(ns);
+        mean /= static_cast<double>(sorted.size());
+        const int64_t p50 = percentile(sorted, 0.50);
+        const double runs = static_cast<double>(samples.ns.size());
+        const double mb_s = p50 > 0 ? (static_cast<double>(bytes) / 1e6) / (static_cast<double>(p50) / 1e9) : 0.0;
+        const double ns_per_op = operations ? static_cast<double>(p50) / static_cast<double>(operations) : 0.0;
+
+        std::printf("{\"library\":\"%s\",\"corpus\":\"%s\",\"phase\":\"%s\",\"scale\":%g,\"seed\":%llu,"
+                    "\"bytes\":%zu,\"operations\":%zu,\"iterations\":%zu,"
+                    "\"min_ns\":%lld,\"p50_ns\":%lld,\"p90_ns\":%lld,\"p99_ns\":%lld,\"max_ns\":%lld,\"mean_ns\":%.1f,"
+                    "\"throughput_mb_s\":%.2f,\"ns_per_op\":%.1f,"
+                    "\"allocations\":%.1f,\"allocated_bytes\":%.1f%s%s}\n",
+                    library.c_str(), corpus.name.c_str(), phase, options.scale,
+                    static_cast<unsigned long long>(options.seed),
+                    bytes, operations, samples.ns.size(),
+                    static_cast<long long>(sorted.front()), static_cast<long long>(p50),
+                    static_cast<long long>(percentile(sorted, 0.90)), static_cast<long long>(percentile(sorted, 0.99)),
+                    static_cast<long long>(sorted.back()), mean,
+                    mb_s, ns_per_op,
+                    static_cast<double>(samples.allocations) / runs,
+                    static_cast<double>(samples.allocated_bytes) / runs,
+                    perfFields(samples, bytes, tokens).c_str(), extra.c_str());
+    }
+
+    // Split an NDJSON corpus into its records; whole documents stay as a single entry
+    std::vector<std::string> splitDocuments(const Corpus& corpus) {
+        std::vector<std::string> documents;
+        if (!corpus.ndjson) {
+            documents.push_back(corpus.json);
+            return documents;
+        }
+        size_t start = 0;
+        while (start < corpus.json.size()) {
+            size_t end = corpus.json.find('\n', start);
+            if (end == std::string::npos) end = corpus.json.size();
+            if (end > start) documents.emplace_back(corpus.json, start, end - start);
+            start = end + 1;
+        }
+        return documents;
+    }
+
+    // Convert a lazyjson path ("a.b[3].c") into a JSON pointer ("/a/b/3/c")
+    std::string toJsonPointer(const std::string& path) {
+        std::string pointer;
+        for (char c : path) {
+            switch (c) {
+                case '.':
+                case '[': pointer.push_back('/'); break;
+                case ']': break;
+                case '~': pointer.append("~0"); break;
+                case '/': pointer.append("~1"); break;
+                default: pointer.push_back(c); break;
+            }
+        }
+        if (pointer.empty() || pointer[0] != '/') pointer.insert(pointer.begin(), '/');
+        return pointer;
+    }
+
+    // Prevent the optimizer from dropping results
+    volatile size_t g_sink = 0;
+
+    // Phases shared by every library. Each adapter provides:
+    //   Document                           parsed representation of one input
+    //   bool tokenize(std::string&)        (optional phase, return false if unsupported)
+    //   std::unique_ptr<Document> parse(std::string&)
+    //   size_t get(Document&, const std::string& path, const std::string& pointer)
+    //   std::string dump(Document&)
+    template<typename Adapter>
+    void runLibrary(const Options& options, const Corpus& corpus, size_t tokens) {
+        std::vector<std::string> documents = splitDocuments(corpus);
+        std::vector<std::string> pointers;
+        for (const auto& path : corpus.paths) pointers.push_back(toJsonPointer(path));
+        const size_t get_ops = corpus.paths.size() * documents.size();
+
+        PhaseSamples tokenize, parse, first_get, repeated_get, dump, teardown;
+        bool has_tokenize = true;
+        Adapter adapter;
+
+        for (size_t it = 0; it < options.warmup + options.iterations; it++) {
+            const bool record = it >= options.warmup;
+            std::vector<std::unique_ptr<typename Adapter::Document>> parsed;
+            parsed.reserve(documents.size());
+
+            measure(tokenize, record && has_tokenize, [&] {
+                for (auto& document : documents) {
+                    if (!adapter.tokenize(document)) {
+                        has_tokenize = false;
+                        break;
+                    }
+                }
+            });
+            measure(parse, record, [&] {
+                for (auto& document : documents) {
+                    parsed.push_back(adapter.parse(document));
+                }
+            });
+            for (auto* samples : {&first_get, &repeated_get}) {
+                measure(*samples, record, [&] {
+                    size_t found = 0;
+                    for (auto& document : parsed) {
+                        for (size_t p = 0; p < corpus.paths.size(); p++) {
+                            found += adapter.get(*document, corpus.paths[p], pointers[p]);
+                        }
+                    }
+                    g_sink = g_sink + found;
+                });
+            }
+            measure(dump, record, [&] {
+                size_t total = 0;
+                for (auto& document : parsed) {
+                    total += adapter.dump(*document).size();
+                }
+                g_sink = g_sink + total;
+            });
+            measure(teardown, record, [&] {
+                parsed.clear();
+            });
+        }
+
+        const size_t bytes = corpus.json.size();
+        if (has_tokenize) report(options, Adapter::name, corpus, "tokenize", bytes, tokens, documents.size(), tokenize);
+        report(options, Adapter::name, corpus, "parse", bytes, tokens, documents.size(), parse);
+        report(options, Adapter::name, corpus, "first_get", bytes, tokens, get_ops, first_get);
+        report(options, Adapter::name, corpus, "repeated_get", bytes, tokens, get_ops, repeated_get);
+        report(options, Adapter::name, corpus, "dump", bytes, tokens, documents.size(), dump);
+        report(options, Adapter::name, corpus, "teardown", bytes, tokens, documents.size(), teardown);
+    }
+
+    // Raw text re-emission with minify/prettify, over the whole corpus text
+    void runFormat(const Options& options, const Corpus& corpus, size_t tokens) {
+        const std::string pretty = lazyjson::prettify(corpus.json);
+        std::vector<char> out(pretty.size());
+        PhaseSamples minify, minify_pretty, prettify;
+        for (size_t it = 0; it < options.warmup + options.iterations; it++) {
+            const bool record = it >= options.warmup;
+            measure(minify, record, [&] { g_sink = g_sink + lazyjson::minify(corpus.json, out.data()); });
+            measure(minify_pretty, record, [&] { g_sink = g_sink + lazyjson::minify(pretty, out.data()); });
+            measure(prettify, record, [&] { g_sink = g_sink + lazyjson::prettify(corpus.json, out.data(), out.size()); });
+        }
+        report(options, "lazyjson", corpus, "minify", corpus.json.size(), tokens, 1, minify);
+        report(options, "lazyjson", corpus, "minify_pretty", pretty.size(), tokens, 1, minify_pretty);
+        report(options, "lazyjson", corpus, "prettify", corpus.json.size(), tokens, 1, prettify);
+    }
+
+    struct LazyJsonAdapter {
+        static constexpr const char* name = "lazyjson";
+        using Document = lazyjson::Parser;
+        lazyjson::Tokenizer tokenizer;
+        // Documents of a corpus share their object layouts
+        std::shared_ptr<lazyjson::ShapeCache> shapes = std::make_shared<lazyjson::ShapeCache>();
+
+        bool tokenize(std::string& json) {
+            lazyjson::TokenizerError error;
+            if (tokenizer.tokenize(json, error) != 0) {
+                throw std::runtime_error("lazyjson failed to tokenize the corpus");
+            }
+            return true;
+        }
+        std::unique_ptr<Document> parse(std::string& json) {
+            auto parser = std::make_unique<Document>();
+            parser->setShapeCache(shapes);
+            if (!parser->parse(json)) {
+                throw std::runtime_error("lazyjson failed to parse the corpus");
+            }
+            return parser;
+        }
+        size_t get(Document& parser, const std::string& path, const std::string&) {
+            lazyjson::ElementPtr element;
+            return parser.get(path, element) == 0 && element ? 1 : 0;
+        }
+        std::string dump(Document& parser) { return parser.dump(); }
+    };
+
+#ifdef LAZYJSON_BENCH_WITH_NLOHMANN
+    struct NlohmannAdapter {
+        static constexpr const char* name = "nlohmann";
+        using Document = nlohmann::json;
+
+        bool tokenize(std::string&) { return false; }
+        std::unique_ptr<Document> parse(std::string& json) {
+            return std::make_unique<Document>(Document::parse(json));
+        }
+        size_t get(Document& document, const std::string&, const std::string& pointer) {
+            const auto& value = document.at(nlohmann::json::json_pointer(pointer));
+            return value.is_discarded() ? 0 : 1;
+        }
+        std::string dump(Document& document) { return document.dump(); }
+    };
+#endif
+
+#ifdef LAZYJSON_BENCH_WITH_RAPIDJSON
+    struct RapidJsonAdapter {
+        static constexpr const char* name = "rapidjson";
+        using Document = rapidjson::Document;
+
+        bool tokenize(std::string&) { return false; }
+        std::unique_ptr<Document> parse(std::string& json) {
+            auto document = std::make_unique<Document>();
+            if (document->Parse(json.c_str(), json.size()).HasParseError()) {
+                throw std::runtime_error("rapidjson failed to parse the corpus");
+            }
+            return document;
+        }
+        size_t get(Document& document, const std::string&, const std::string& pointer) {
+            return rapidjson::Pointer(pointer.c_str(), pointer.size()).Get(document) ? 1 : 0;
+        }
+        std::string dump(Document& document) {
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            document.Accept(writer);
+            return std::string(buffer.GetString(), buffer.GetSize());
+        }
+    };
+#endif
+
+    // Request latency under load: every thread parses each document of the corpus
+    // and resolves the corpus paths, either with a new Parser per request or with
+    // a parser leased from a shared ParserPool. One sample per request.
+    void runConcurrency(const Options& options, const Corpus& corpus) {
+        const std::vector<std::string> documents = splitDocuments(corpus);
+        const size_t bytes = corpus.json.size() / documents.size();
+        lazyjson::ParserPool pool;
+
+        auto query = [&](lazyjson::Parser& parser, std::string& document) {
+            if (!parser.parse(document)) {
+                throw std::runtime_error("lazyjson failed to parse the corpus");
+            }
+            size_t found = 0;
+            lazyjson::ElementPtr element;
+            for (const auto& path : corpus.paths) {
+                found += parser.get(path, element) == 0 && element ? 1 : 0;
+            }
+            return found;
+        };
+
+        for (const bool pooled : {false, true}) {
+            // Private copies, made before measuring (parse takes a mutable string)
+            std::vector<std::vector<std::string>> inputs(options.threads, documents);
+            std::vector<std::vector<int64_t>> latencies(options.threads);
+            for (auto& samples : latencies) samples.reserve(options.iterations * documents.size());
+
+            AllocSnapshot before;
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < options.threads; t++) {
+                threads.emplace_back([&, t] {
+                    size_t found = 0;
+                    for (size_t it = 0; it < options.warmup + options.iterations; it++) {
+                        for (auto& document : inputs[t]) {
+                            auto start = Clock::now();
+                            if (pooled) {
+                                auto parser = pool.acquire();
+                                found += query(*parser, document);
+                            } else {
+                                lazyjson::Parser parser;
+                                found += query(parser, document);
+                            }
+                            auto end = Clock::now();
+                            if (it >= options.warmup) {
+                                latencies[t].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+                            }
+                        }
+                    }
+                    g_sink = g_sink + found;
+                });
+            }
+            for (auto& thread : threads) thread.join();
+            AllocSnapshot after;
+
+            PhaseSamples samples;
+            for (const auto& thread_samples : latencies) {
+                samples.ns.insert(samples.ns.end(), thread_samples.begin(), thread_samples.end());
+            }
+            // Allocations are counted globally, warmup included: scale to the recorded requests
+            const double recorded = static_cast<double>(samples.ns.size())
+                                  / static_cast<double>(options.threads * (options.warmup + options.iterations) * documents.size());
+            samples.allocations = static_cast<uint64_t>(static_cast<double>(after.count - before.count) * recorded);
+            samples.allocated_bytes = static_cast<uint64_t>(static_cast<double>(after.bytes - before.bytes) * recorded);
+            report(options, "lazyjson", corpus, pooled ? "request_pooled" : "request_new_parser",
+                   bytes, 0, 1, samples, ",\"threads\":" + std::to_string(options.threads));
+        }
+    }
+
+    struct CacheCounters {
+        uint64_t hits, misses, evictions;
+    };
+
+    template<typename Cache>
+    CacheCounters cacheCounters(const Cache& cache) {
+        const auto stats = cache.stats();
+        return {stats.hits, stats.misses, stats.evictions};
+    }
+
+    // ShardedCache hit ratio and contention: every thread looks up path-like keys
+    // drawn from a Zipf(0.99) distribution and inserts them on a miss, as a shared
+    // resolved-path cache would. The cache holds a fraction of the key space; the
+    // single shard runs show what the sharding saves when threads share one lock.
+    void runCache(const Options& options) {
+        using Cache = lazyjson::ShardedCache<uint64_t>;
+        const size_t key_count = std::max<size_t>(1000, static_cast<size_t>(100000 * options.scale));
+        const size_t operations = 1000000;
+        const size_t thread_count = std::max<size_t>(1, options.threads);
+
+        std::vector<std::string> keys(key_count);
+        size_t key_bytes = 0;
+        for (size_t i = 0; i < key_count; i++) {
+            keys[i] = "items[" + std::to_string(i) + "].attributes.name";
+            key_bytes += keys[i].size();
+        }
+        std::vector<double> cdf(key_count);
+        double total = 0;
+        for (size_t i = 0; i < key_count; i++) {
+            total += 1.0 / std::pow(static_cast<double>(i + 1), 0.99);
+            cdf[i] = total;
+        }
+        // Key sequences drawn before measuring, one per thread
+        std::vector<std::vector<uint32_t>> sequences(thread_count);
+        for (size_t t = 0; t < thread_count; t++) {
+            Random random(options.seed + t);
+            sequences[t].resize(operations);
+            for (auto& key : sequences[t]) {
+                const double u = random.real(0, total);
+                key = static_cast<uint32_t>(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+            }
+        }
+
+        const size_t entry_bytes = key_bytes / key_count + Cache::kEntryOverhead;
+        for (const double ratio : {0.01, 0.1, 0.5}) {
+            for (const size_t shards : {size_t(1), size_t(0)}) {
+                Cache cache(std::max<size_t>(1, static_cast<size_t>(ratio * static_cast<double>(key_count))) * entry_bytes, shards);
+                for (size_t it = 0; it < options.warmup + options.iterations; it++) {
+                    if (it == options.warmup) cache.clear();
+                    const CacheCounters before = cacheCounters(cache);
+                    auto start = Clock::now();
+                    std::vector<std::thread> threads;
+                    for (size_t t = 0; t < thread_count; t++) {
+                        threads.emplace_back([&, t] {
+                            size_t found = 0;
+                            uint64_t value = 0;
+                            for (const uint32_t key : sequences[t]) {
+                                const uint64_t key_hash = Cache::hash(keys[key]);
+                                if (cache.lookup(key_hash, keys[key], value)) {
+                                    found += value;
+                                } else {
+                                    cache.insert(key_hash, keys[key], key);
+                                }
+                            }
+                            g_sink = g_sink + found;
+                        });
+                    }
+                    for (auto& thread : threads) thread.join();
+                    auto end = Clock::now();
+                    if (it < options.warmup) continue;
+                    const CacheCounters after = cacheCounters(cache);
+                    const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+                    const double ops = static_cast<double>(operations * thread_count);
+                    const double lookups = static_cast<double>(after.hits + after.misses - before.hits - before.misses);
+                    std::printf("{\"library\":\"lazyjson\",\"corpus\":\"cache\",\"phase\":\"sharded_cache\",\"seed\":%llu,"
+                                "\"keys\":%zu,\"capacity_ratio\":%g,\"shards\":%zu,\"threads\":%zu,\"iteration\":%zu,"
+                                "\"hit_ratio\":%.4f,\"evictions\":%llu,\"ns_per_op\":%.1f,\"mops_per_s\":%.2f}\n",
+                                static_cast<unsigned long long>(options.seed), key_count, ratio, cache.shardCount(),
+                                thread_count, it - options.warmup,
+                                lookups > 0 ? static_cast<double>(after.hits - before.hits) / lookups : 0.0,
+                                static_cast<unsigned long long>(after.evictions - before.evictions),
+                                ns * static_cast<double>(thread_count) / ops, ops / ns * 1e3);
+                }
+            }
+        }
+    }
+
+    // Write a `bytes` long document {"records":[...]} to `path`; returns the record count
+    size_t writeLargeDocument(const std::string& path, size_t bytes, uint64_t seed) {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            throw std::runtime_error("cannot create " + path);
+        }
+        Random random(seed);
+        std::string chunk = "{\"records\":[\n";
+        size_t written = 0;
+        size_t records = 0;
+        while (written + chunk.size() < bytes) {
+            if (records > 0) chunk.append(",\n");
+            const std::string id = std::to_string(records);
+            chunk.append("{\"id\":").append(id)
+                 .append(",\"name\":\"record ").append(id)
+                 .append("\",\"active\":").append(random.chance(50) ? "true" : "false")
+                 .append(",\"tags\":[\"a\",\"b\",\"c\"],\"position\":{\"x\":")
+                 .append(std::to_string(random.range(100000))).append(".5,\"y\":-")
+                 .append(std::to_string(random.range(100000))).append("}}");
+            records++;
+            if (chunk.size() >= (1 << 20)) {
+                written += std::fwrite(chunk.data(), 1, chunk.size(), file);
+                chunk.clear();
+            }
+        }
+        chunk.append("\n]}\n");
+        written += std::fwrite(chunk.data(), 1, chunk.size(), file);
+        if (std::fclose(file) != 0 || records == 0) {
+            throw std::runtime_error("cannot write " + path);
+        }
+        return records;
+    }
+
+    // Documents past 4 GB: Parser::load of a generated file without its sidecar
+    // (tokenize, jump table, 64 bit tape write), then with it (tape reload only),
+    // then a lookup of the last record. Every iteration maps the file again; the
+    // file and its sidecar are removed at the end.
+    void runLarge(const Options& options) {
+        const size_t bytes = static_cast<size_t>(options.large * 1e9);
+        const std::string tape_path = options.large_path + ".tape";
+        const size_t records = writeLargeDocument(options.large_path, bytes, options.seed);
+        Corpus corpus;
+        corpus.name = "large";
+        corpus.paths = {"records[" + std::to_string(records - 1) + "].position.x"};
+
+        lazyjson::Parser parser;
+        PhaseSamples tokenize, tape, get;
+        size_t tokens = 0;
+        for (size_t it = 0; it < options.warmup + options.iterations; it++) {
+            const bool record = it >= options.warmup;
+            std::remove(tape_path.c_str());
+            measure(tokenize, record, [&] {
+                if (!parser.load(options.large_path, tape_path)) {
+                    throw std::runtime_error("lazyjson failed to load the large document");
+                }
+            });
+            tokens = parser.getTokens().size();
+            measure(tape, record, [&] {
+                if (!parser.load(options.large_path, tape_path, lazyjson::TapeValidation::SIZE_ONLY)) {
+                    throw std::runtime_error("lazyjson failed to reload the large document");
+                }
+            });
+            measure(get, record, [&] {
+                lazyjson::ElementPtr element;
+                g_sink = g_sink + (parser.get(corpus.paths[0], element) == 0 && element ? 1 : 0);
+            });
+        }
+        std::remove(tape_path.c_str());
+        std::remove(options.large_path.c_str());
+
+        const std::string extra = ",\"records\":" + std::to_string(records) + ",\"tokens\":" + std::to_string(tokens);
+        report(options, "lazyjson", corpus, "large_load_tokenize", bytes, tokens, 1, tokenize, extra);
+        report(options, "lazyjson", corpus, "large_load_tape", bytes, tokens, 1, tape, extra);
+        report(options, "lazyjson", corpus, "large_get", bytes, tokens, 1, get, extra);
+    }
+
+    // Number of tokens of the corpus according to the lazyjson tokenizer
+    size_t countTokens(const Corpus& corpus) {
+        lazyjson::Tokenizer tokenizer;
+        lazyjson::TokenizerError error;
+        size_t tokens = 0;
+        for (auto& document : splitDocuments(corpus)) {
+            if (tokenizer.tokenize(document, error) == 0) {
+                tokens += tokenizer.getTokens().size();
+            }
+        }
+        return tokens;
+    }
+
+    std::vector<std::string> splitList(const std::string& list) {
+        std::vector<std::string> items;
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t end = list.find(',', start);
+            if (end == std::string::npos) end = list.size();
+            if (end > start) items.push_back(list.substr(start, end - start));
+            start = end + 1;
+        }
+        return items;
+    }
+
+    void usage() {
+        std::cerr << "Usage: lazyjson_bench [--iterations=N] [--warmup=N] [--scale=X] [--seed=N]\n"
+                     "                      [--corpus=name[,name...]] [--library=name[,name...]] [--perf]\n"
+                     "                      [--threads=N] [--cache] [--large=GB [--large-path=file]]\n"
+                     "Corpora:";
+        for (const auto& name : corpusNames()) std::cerr << " " << name;
+        std::cerr << "\nLibraries: lazyjson";
+#ifdef LAZYJSON_BENCH_WITH_NLOHMANN
+        std::cerr << " nlohmann";
+#endif
+#ifdef LAZYJSON_BENCH_WITH_RAPIDJSON
+        std::cerr << " rapidjson";
+#endif
+        std::cerr << "\nOutput: one JSON object per (library, corpus, phase) on stdout\n"
+                     "--perf adds hardware counters (cycles, instructions, branch/L1D/LLC misses) when available\n"
+                     "--threads=N measures lazyjson request latency on N threads, new parser vs ParserPool\n"
+                     "--cache measures ShardedCache hit ratio and throughput (on --threads=N threads, default 1)\n"
+                     "--large=GB generates a document of that size (default file lazyjson_large.json) and measures\n"
+                     "           load without and with its token tape sidecar\n";
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto value = [&](const char* prefix) -> const char* {
+                size_t len = std::char_traits<char>::length(prefix);
+                return arg.compare(0, len, prefix) == 0 ? arg.c_str() + len : nullptr;
+            };
+            if (const char* v = value("--iterations=")) options.iterations = std::strtoull(v, nullptr, 10);
+            else if (const char* v = value("--warmup=")) options.warmup = std::strtoull(v, nullptr, 10);
+            else if (const char* v = value("--scale=")) options.scale = std::strtod(v, nullptr);
+            else if (const char* v = value("--seed=")) options.seed = std::strtoull(v, nullptr, 10);
+            else if (const char* v = value("--corpus=")) options.corpora = splitList(v);
+            else if (const char* v = value("--library=")) options.libraries = splitList(v);
+            else if (const char* v = value("--threads=")) options.threads = std::strtoull(v, nullptr, 10);
+            else if (const char* v = value("--large=")) options.large = std::strtod(v, nullptr);
+            else if (const char* v = value("--large-path=")) options.large_path = v;
+            else if (arg == "--perf") options.perf = true;
+            else if (arg == "--cache") options.cache = true;
+            else return false;
+        }
+        if (options.corpora.empty()) options.corpora = corpusNames();
+        if (options.libraries.empty()) options.libraries = {"lazyjson", "nlohmann", "rapidjson"};
+        return options.iterations > 0 && options.scale > 0;
+    }
+
+} // namespace lazyjson_bench
+
+int main(int argc, char** argv) {
+    using namespace lazyjson_bench;
+
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+
+    auto selected = [&](const char* library) {
+        return std::find(options.libraries.begin(), options.libraries.end(), library) != options.libraries.end();
+    };
+
+    PerfCounters perf;
+    if (options.perf) {
+        if (perf.open()) {
+            g_perf = &perf;
+        } else {
+            // Fall back to wall clock only, the report simply omits the counter fields
+            std::cerr << "Hardware counters unavailable (" << perf.error() << "), reporting wall clock only" << std::endl;
+        }
+    }
+
+    try {
+        if (options.cache) {
+            runCache(options);
+            return 0;
+        }
+        if (options.large > 0) {
+            runLarge(options);
+            return 0;
+        }
+        for (const auto& name : options.corpora) {
+            const Corpus corpus = makeCorpus(name, options.scale, options.seed);
+            if (options.threads > 0) {
+                runConcurrency(options, corpus);
+                std::fflush(stdout);
+                continue;
+            }
+            const size_t tokens = countTokens(corpus);
+            if (selected("lazyjson")) {
+                runLibrary<LazyJsonAdapter>(options, corpus, tokens);
+                runFormat(options, corpus, tokens);
+            }
+#ifdef LAZYJSON_BENCH_WITH_NLOHMANN
+            if (selected("nlohmann")) runLibrary<NlohmannAdapter>(options, corpus, tokens);
+#endif
+#ifdef LAZYJSON_BENCH_WITH_RAPIDJSON
+            if (selected("rapidjson")) runLibrary<RapidJsonAdapter>(options, corpus, tokens);
+#endif
+            std::fflush(stdout);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
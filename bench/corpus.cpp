@@ -0,0 +1,329 @@
+#include "corpus.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace lazyjson_bench {
+
+    namespace {
+
+        size_t scaled(size_t base, double scale) {
+            return std::max<size_t>(1, static_cast<size_t>(static_cast<double>(base) * scale));
+        }
+
+        void appendNumber(std::string& out, double value) {
+            char buffer[32];
+            int n = std::snprintf(buffer, sizeof(buffer), "%.6g", value);
+            out.append(buffer, static_cast<size_t>(n));
+        }
+
+        void appendQuoted(std::string& out, const std::string& value) {
+            out.push_back('"');
+            out.append(value);
+            out.push_back('"');
+        }
+
+        // { "key_0": ..., "key_1": ..., ... } with mixed primitive values
+        Corpus wideObject(double scale, Random& rnd) {
+            Corpus corpus;
+            corpus.name = "wide_object";
+            const size_t keys = scaled(40000, scale);
+            std::string& out = corpus.json;
+            out.reserve(keys * 32);
+            out.push_back('{');
+            for (size_t i = 0; i < keys; i++) {
+                if (i) out.push_back(',');
+                appendQuoted(out, "key_" + std::to_string(i));
+                out.push_back(':');
+                switch (i % 4) {
+                    case 0: appendNumber(out, rnd.real(-1e6, 1e6)); break;
+                    case 1: appendQuoted(out, rnd.word(4, 16)); break;
+                    case 2: out.append(rnd.chance(50) ? "true" : "false"); break;
+                    default: out.append("null"); break;
+                }
+            }
+            out.push_back('}');
+            for (size_t i : {size_t(0), keys / 2, keys - 1}) {
+                corpus.paths.push_back("key_" + std::to_string(i));
+            }
+            return corpus;
+        }
+
+        // {"tree_0":{"level":[{"level":{"level":[{ ... N ... }]}}]}, ...} alternating objects and arrays
+        Corpus deepNesting(double scale, Random& rnd) {
+            Corpus corpus;
+            corpus.name = "deep_nesting";
+            const size_t depth = 256;
+            const size_t copies = scaled(64, scale);
+            std::string& out = corpus.json;
+            out.push_back('{');
+            for (size_t c = 0; c < copies; c++) {
+                if (c) out.push_back(',');
+                appendQuoted(out, "tree_" + std::to_string(c));
+                out.push_back(':');
+                for (size_t d = 0; d < depth; d++) {
+                    out.append(d % 2 ? "[{\"level\":" : "{\"level\":");
+                }
+                appendNumber(out, static_cast<double>(rnd.range(1000)));
+                for (size_t d = depth; d > 0; d--) {
+                    out.append((d - 1) % 2 ? "}]" : "}");
+                }
+            }
+            out.push_back('}');
+            std::string path = "tree_" + std::to_string(copies - 1);
+            for (size_t d = 0; d < depth; d++) {
+                path.append(d % 2 ? "[0].level" : ".level");
+            }
+            corpus.paths.push_back(path);
+            corpus.paths.push_back("tree_0.level[0].level.level[0].level");
+            return corpus;
+        }
+
+        // {"values":[...], "ints":[...]} with large numeric arrays
+        Corpus numericArray(double scale, Random& rnd) {
+            Corpus corpus;
+            corpus.name = "numeric_array";
+            const size_t count = scaled(100000, scale);
+            std::string& out = corpus.json;
+            out.reserve(count * 20);
+            out.append("{\"values\":[");
+            for (size_t i = 0; i < count; i++) {
+                if (i) out.push_back(',');
+                appendNumber(out, rnd.real(-1000.0, 1000.0));
+            }
+            out.append("],\"ints\":[");
+            for (size_t i = 0; i < count; i++) {
+                if (i) out.push_back(',');
+                out.append(std::to_string(rnd.range(1000000)));
+            }
+            out.append("]}");
+            corpus.paths = {
+                "values[0]",
+                "values[" + std::to_string(count / 2) + "]",
+                "ints[" + std::to_string(count - 1) + "]"
+            };
+            return corpus;
+        }
+
+        std::string logMessage(Random& rnd) {
+            static const char* const templates[] = {
+                "connection from \\\"%s\\\" accepted",
+                "request %s completed\\twith status ok",
+                "retrying %s after timeout\\nstack: frame_a frame_b",
+                "user %s updated profile \\u00e8 settings",
+            };
+            std::string word = rnd.word(6, 24);
+            char buffer[160];
+            int n = std::snprintf(buffer, sizeof(buffer), templates[rnd.range(4)], word.c_str());
+            return std::string(buffer, static_cast<size_t>(n));
+        }
+
+        void appendLogRecord(std::string& out, size_t i, Random& rnd) {
+            static const char* const levels[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+            out.append("{\"ts\":");
+            out.append(std::to_string(1700000000000ULL + i * 17));
+            out.append(",\"level\":");
+            appendQuoted(out, levels[rnd.range(4)]);
+            out.append(",\"host\":");
+            appendQuoted(out, "node-" + std::to_string(rnd.range(64)));
+            out.append(",\"message\":");
+            appendQuoted(out, logMessage(rnd));
+            out.append(",\"tags\":[");
+            size_t tags = 1 + rnd.range(4);
+            for (size_t t = 0; t < tags; t++) {
+                if (t) out.push_back(',');
+                appendQuoted(out, rnd.word(3, 10));
+            }
+            out.append("]}");
+        }
+
+        // {"logs":[{"ts":..,"level":..,"message":..}, ...]}
+        Corpus stringLogs(double scale, Random& rnd) {
+            Corpus corpus;
+            corpus.name = "string_logs";
+            const size_t records = scaled(12000, scale);
+            std::string& out = corpus.json;
+            out.reserve(records * 160);
+            out.append("{\"logs\":[");
+            for (size_t i = 0; i < records; i++) {
+                if (i) out.push_back(',');
+                appendLogRecord(out, i, rnd);
+            }
+            out.append("]}");
+            corpus.paths = {
+                "logs[0].message",
+                "logs[" + std::to_string(records / 2) + "].tags[0]",
+                "logs[" + std::to_string(records - 1) + "].level"
+            };
+            return corpus;
+        }
+
+        // One log record per line
+        Corpus ndjson(double scale, Random& rnd) {
+            Corpus corpus;
+            corpus.name = "ndjson";
+            corpus.ndjson = true;
+            const size_t records = scaled(12000, scale);
+            std::string& out = corpus.json;
+            out.reserve(records * 160);
+            for (size_t i = 0; i < records; i++) {
+                appendLogRecord(out, i, rnd);
+                out.push_back('\n');
+            }
+            corpus.paths = {"level", "message", "tags[0]"};
+            return corpus;
+        }
+
+        void appendUser(std::string& out, Random& rnd) {
+            out.append("{\"id\":");
+            out.append(std::to_string(rnd.range(1000000000)));
+            out.append(",\"screen_name\":");
+            appendQuoted(out, rnd.word(5, 15));
+            out.append(",\"name\":");
+            appendQuoted(out, rnd.word(4, 10) + " " + rnd.word(4, 12));
+            out.append(",\"description\":");
+            appendQuoted(out, logMessage(rnd));
+            out.append(",\"followers_count\":");
+            out.append(std::to_string(rnd.range(100000)));
+            out.append(",\"verified\":");
+            out.append(rnd.chance(5) ? "true" : "false");
+            out.append(",\"profile_image_url\":");
+            appendQuoted(out, "https://img.example.com/" + rnd.word(12, 12) + ".png");
+            out.append("}");
+        }
+
+        // Twitter search API like: {"statuses":[{..., "user":{...}, "entities":{...}}], "search_metadata":{...}}
+        Corpus twitterLike(double scale, Random& rnd) {
+            Corpus corpus;
+            corpus.name = "twitter_like";
+            const size_t statuses = scaled(2500, scale);
+            std::string& out = corpus.json;
+            out.reserve(statuses * 700);
+            out.append("{\"statuses\":[");
+            for (size_t i = 0; i < statuses; i++) {
+                if (i) out.push_back(',');
+                out.append("{\"created_at\":\"Sun Aug 31 00:29:15 +0000 2014\",\"id\":");
+                out.append(std::to_string(505874924095815700ULL + i));
+                out.append(",\"text\":");
+                appendQuoted(out, logMessage(rnd) + " " + rnd.word(10, 40));
+                out.append(",\"truncated\":false,\"in_reply_to_status_id\":null,\"user\":");
+                appendUser(out, rnd);
+                out.append(",\"geo\":null,\"retweet_count\":");
+                out.append(std::to_string(rnd.range(500)));
+                out.append(",\"entities\":{\"hashtags\":[");
+                size_t tags = rnd.range(3);
+                for (size_t t = 0; t < tags; t++) {
+                    if (t) out.push_back(',');
+                    out.append("{\"text\":");
+                    appendQuoted(out, rnd.word(4, 12));
+                    out.append(",\"indices\":[");
+                    out.append(std::to_string(t * 10));
+                    out.push_back(',');
+                    out.append(std::to_string(t * 10 + 8));
+                    out.append("]}");
+                }
+                out.append("],\"urls\":[],\"user_mentions\":[]},\"lang\":\"en\"}");
+            }
+            out.append("],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815700,");
+            out.append("\"query\":\"%E4%B8%80\",\"count\":");
+            out.append(std::to_string(statuses));
+            out.append("}}");
+            corpus.paths = {
+                "search_metadata.count",
+                "statuses[0].user.screen_name",
+                "statuses[" + std::to_string(statuses / 2) + "].retweet_count",
+                "statuses[" + std::to_string(statuses - 1) + "].user.followers_count"
+            };
+            return corpus;
+        }
+
+        // citm_catalog like: big id-keyed maps plus performances with nested price arrays
+        Corpus citmLike(double scale, Random& rnd) {
+            Corpus corpus;
+            corpus.name = "citm_like";
+            const size_t events = scaled(3000, scale);
+            const size_t performances = scaled(6000, scale);
+            std::string& out = corpus.json;
+            out.reserve((events + performances) * 220);
+            out.append("{\"areaNames\":{");
+            for (size_t i = 0; i < 200; i++) {
+                if (i) out.push_back(',');
+                appendQuoted(out, std::to_string(205705993 + i));
+                out.push_back(':');
+                appendQuoted(out, rnd.word(5, 20));
+            }
+            out.append("},\"events\":{");
+            for (size_t i = 0; i < events; i++) {
+                if (i) out.push_back(',');
+                std::string id = std::to_string(138586341 + i);
+                appendQuoted(out, id);
+                out.append(":{\"description\":null,\"id\":");
+                out.append(id);
+                out.append(",\"logo\":");
+                if (rnd.chance(30)) {
+                    appendQuoted(out, "/images/UE0AAAAACEKo6QAAAAZDSVRN");
+                } else {
+                    out.append("null");
+                }
+                out.append(",\"name\":");
+                appendQuoted(out, rnd.word(8, 30));
+                out.append(",\"subTopicIds\":[337184269,337184283],\"subjectCode\":null,\"subtitle\":null,\"topicIds\":[324846099,107888604]}");
+            }
+            out.append("},\"performances\":[");
+            for (size_t i = 0; i < performances; i++) {
+                if (i) out.push_back(',');
+                out.append("{\"eventId\":");
+                out.append(std::to_string(138586341 + rnd.range(events)));
+                out.append(",\"id\":");
+                out.append(std::to_string(339887544 + i));
+                out.append(",\"logo\":null,\"name\":null,\"prices\":[");
+                size_t prices = 1 + rnd.range(4);
+                for (size_t p = 0; p < prices; p++) {
+                    if (p) out.push_back(',');
+                    out.append("{\"amount\":");
+                    out.append(std::to_string(9000 + rnd.range(100000)));
+                    out.append(",\"audienceSubCategoryId\":337100890,\"seatCategoryId\":");
+                    out.append(std::to_string(338937295 + p));
+                    out.push_back('}');
+                }
+                out.append("],\"seatCategories\":[{\"areas\":[{\"areaId\":205705999,\"blockIds\":[]}],\"seatCategoryId\":338937295}],");
+                out.append("\"seatMapImage\":null,\"start\":");
+                out.append(std::to_string(1372701600000ULL + i * 3600000ULL));
+                out.append(",\"venueCode\":\"PLEYEL_PLEYEL\"}");
+            }
+            out.append("]}");
+            corpus.paths = {
+                "areaNames.205706000",
+                "events." + std::to_string(138586341 + events / 2) + ".name",
+                "performances[" + std::to_string(performances - 1) + "].prices[0].amount"
+            };
+            return corpus;
+        }
+
+    } // namespace
+
+    const std::vector<std::string>& corpusNames() {
+        static const std::vector<std::string> names = {
+            "wide_object", "deep_nesting", "numeric_array", "string_logs", "ndjson", "twitter_like", "citm_like"
+        };
+        return names;
+    }
+
+    Corpus makeCorpus(const std::string& name, double scale, uint64_t seed) {
+        // Each corpus gets its own stream so that selecting a subset does not change the others
+        uint64_t name_hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : name) {
+            name_hash = (name_hash ^ c) * 0x100000001b3ULL;
+        }
+        Random rnd(seed ^ name_hash);
+        if (name == "wide_object") return wideObject(scale, rnd);
+        if (name == "deep_nesting") return deepNesting(scale, rnd);
+        if (name == "numeric_array") return numericArray(scale, rnd);
+        if (name == "string_logs") return stringLogs(scale, rnd);
+        if (name == "ndjson") return ndjson(scale, rnd);
+        if (name == "twitter_like") return twitterLike(scale, rnd);
+        if (name == "citm_like") return citmLike(scale, rnd);
+        throw std::invalid_argument("Unknown corpus: " + name);
+    }
+
+} // namespace lazyjson_bench
@@ -0,0 +1,66 @@
+#ifndef LAZYJSON_BENCH_CORPUS_HPP
+#define LAZYJSON_BENCH_CORPUS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lazyjson_bench {
+
+    // Deterministic pseudo random generator (splitmix64).
+    // std::mt19937 + std::uniform_*_distribution are not guaranteed to produce
+    // the same sequence across standard library implementations, so the corpora
+    // are generated with a self contained generator to stay reproducible.
+    class Random {
+    public:
+        explicit Random(uint64_t seed) : state_(seed) {}
+
+        uint64_t next() {
+            uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        uint64_t range(uint64_t max) { return max == 0 ? 0 : next() % max; }
+        bool chance(unsigned percent) { return range(100) < percent; }
+
+        double real(double min, double max) {
+            return min + (max - min) * (static_cast<double>(next() >> 11) / 9007199254740992.0);
+        }
+
+        std::string word(size_t min_len, size_t max_len) {
+            static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz";
+            size_t len = min_len + range(max_len - min_len + 1);
+            std::string out;
+            out.reserve(len);
+            for (size_t i = 0; i < len; i++) {
+                out.push_back(alphabet[range(sizeof(alphabet) - 1)]);
+            }
+            return out;
+        }
+
+    private:
+        uint64_t state_;
+    };
+
+    struct Corpus {
+        std::string name;
+        // Whole document, or one record per line when ndjson is true
+        std::string json;
+        bool ndjson = false;
+        // Paths (lazyjson syntax) looked up by the get phases; for NDJSON
+        // corpora they are applied to every record
+        std::vector<std::string> paths;
+    };
+
+    // Available corpus names, in the order they are reported
+    const std::vector<std::string>& corpusNames();
+
+    // Generate a corpus by name. `scale` multiplies the default size
+    // (roughly 1-2 MB per corpus at scale 1).
+    Corpus makeCorpus(const std::string& name, double scale, uint64_t seed);
+
+} // namespace lazyjson_bench
+
+#endif // LAZYJSON_BENCH_CORPUS_HPP
@@ -0,0 +1,137 @@
+#include "perf_counters.hpp"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace lazyjson_bench {
+
+    PerfReading& PerfReading::operator+=(const PerfReading& other) {
+        for (size_t i = 0; i < kPerfEventCount; i++) {
+            values[i] += other.values[i];
+            valid[i] = valid[i] || other.valid[i];
+        }
+        return *this;
+    }
+
+    const char* PerfCounters::eventName(PerfEvent event) {
+        switch (event) {
+            case PerfEvent::CYCLES:        return "cycles";
+            case PerfEvent::INSTRUCTIONS:  return "instructions";
+            case PerfEvent::BRANCH_MISSES: return "branch_misses";
+            case PerfEvent::L1D_MISSES:    return "l1d_misses";
+            case PerfEvent::LLC_MISSES:    return "llc_misses";
+            default:                       return "unknown";
+        }
+    }
+
+    PerfCounters::PerfCounters() {
+        fds_.fill(-1);
+    }
+
+    PerfCounters::~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+#ifdef __linux__
+
+    namespace {
+
+        void describe(PerfEvent event, perf_event_attr& attr) {
+            attr.type = PERF_TYPE_HARDWARE;
+            switch (event) {
+                case PerfEvent::CYCLES:        attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+                case PerfEvent::INSTRUCTIONS:  attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+                case PerfEvent::BRANCH_MISSES: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+                case PerfEvent::LLC_MISSES:    attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+                case PerfEvent::L1D_MISSES:
+                    attr.type = PERF_TYPE_HW_CACHE;
+                    attr.config = PERF_COUNT_HW_CACHE_L1D
+                                | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                    break;
+                default: break;
+            }
+        }
+
+        struct CounterValue {
+            uint64_t value;
+            uint64_t time_enabled;
+            uint64_t time_running;
+        };
+
+    } // namespace
+
+    bool PerfCounters::open() {
+        for (size_t i = 0; i < kPerfEventCount; i++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            describe(static_cast<PerfEvent>(i), attr);
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fd < 0) {
+                if (error_.empty()) {
+                    error_ = std::string("perf_event_open(") + eventName(static_cast<PerfEvent>(i)) + "): " + std::strerror(errno);
+                }
+                continue;
+            }
+            fds_[i] = fd;
+            available_ = true;
+        }
+        return available_;
+    }
+
+    void PerfCounters::start() {
+        for (int fd : fds_) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    PerfReading PerfCounters::stop() {
+        PerfReading reading;
+        for (size_t i = 0; i < kPerfEventCount; i++) {
+            if (fds_[i] < 0) continue;
+            ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+            CounterValue counter{};
+            if (read(fds_[i], &counter, sizeof(counter)) != static_cast<ssize_t>(sizeof(counter)) || counter.time_running == 0) {
+                continue;
+            }
+            // Scale up when the kernel had to multiplex the PMU between events
+            double scale = static_cast<double>(counter.time_enabled) / static_cast<double>(counter.time_running);
+            reading.values[i] = static_cast<uint64_t>(static_cast<double>(counter.value) * scale);
+            reading.valid[i] = true;
+        }
+        return reading;
+    }
+
+#else
+
+    bool PerfCounters::open() {
+        error_ = "hardware counters are only supported on Linux";
+        return false;
+    }
+
+    void PerfCounters::start() {}
+
+    PerfReading PerfCounters::stop() {
+        return PerfReading{};
+    }
+
+#endif
+
+} // namespace lazyjson_bench
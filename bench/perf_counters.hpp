@@ -0,0 +1,60 @@
+#ifndef LAZYJSON_BENCH_PERF_COUNTERS_HPP
+#define LAZYJSON_BENCH_PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace lazyjson_bench {
+
+    enum class PerfEvent {
+        CYCLES,
+        INSTRUCTIONS,
+        BRANCH_MISSES,
+        L1D_MISSES,
+        LLC_MISSES,
+        COUNT
+    };
+    constexpr size_t kPerfEventCount = static_cast<size_t>(PerfEvent::COUNT);
+
+    // Counter values for one measured region. Events the kernel/PMU refused
+    // to open are marked as not valid and must not be reported.
+    struct PerfReading {
+        std::array<uint64_t, kPerfEventCount> values{};
+        std::array<bool, kPerfEventCount> valid{};
+
+        uint64_t get(PerfEvent event) const { return values[static_cast<size_t>(event)]; }
+        bool has(PerfEvent event) const { return valid[static_cast<size_t>(event)]; }
+        PerfReading& operator+=(const PerfReading& other);
+    };
+
+    // Hardware performance counters of the calling thread via perf_event_open(2).
+    // Every event is opened independently so a PMU lacking one of them (typical
+    // for L1/LLC events in VMs) still provides the others. When nothing can be
+    // opened (non Linux, containers without CAP_PERFMON, perf_event_paranoid
+    // too strict) available() is false and start()/stop() are no-ops.
+    class PerfCounters {
+    public:
+        PerfCounters();
+        ~PerfCounters();
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        bool open();
+        bool available() const { return available_; }
+        const std::string& error() const { return error_; }
+
+        void start();
+        PerfReading stop();
+
+        static const char* eventName(PerfEvent event);
+
+    private:
+        std::array<int, kPerfEventCount> fds_;
+        bool available_ = false;
+        std::string error_;
+    };
+
+} // namespace lazyjson_bench
+
+#endif // LAZYJSON_BENCH_PERF_COUNTERS_HPP
@@ -108,7 +108,7 @@ int main() {
             return 1;
         }
         for (const auto& path : paths) {
-            std::shared_ptr<lazyjson::DataElement> elem;
+            lazyjson::ElementPtr elem;
             auto err = parser.get(path,elem);
             if(err){
                 std::cerr << "Error in retrieving " << path << std::endl;
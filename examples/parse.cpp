@@ -87,7 +87,7 @@ int main() {
     std::vector<long long> times;
     for (const auto& path : paths) {
         auto t_start = high_resolution_clock::now();
-        std::shared_ptr<lazyjson::DataElement> elem;
+        lazyjson::ElementPtr elem;
         auto err = parser.get(path,elem);
         auto t_end = high_resolution_clock::now();
         times.push_back(duration_cast<nanoseconds>(t_end - t_start).count());
@@ -106,10 +106,10 @@ int main() {
     std::cout << "Average get time: " << avg_ns << " ns ("<< paths.size() <<" operations)\n";
     
     {
-        std::shared_ptr<lazyjson::DataElement> new_elem = std::make_shared<lazyjson::DataElement>();
+        lazyjson::ElementPtr new_elem = lazyjson::makeElement();
         auto path = "arr_1[0]";
         auto err = parser.set(path,new_elem);
-        std::shared_ptr<lazyjson::DataElement> get_elem;
+        lazyjson::ElementPtr get_elem;
         err = parser.get(path,get_elem);
         std::cout << "--> Get(" << path << ") -> " << parser.elementToString(get_elem) << std::endl;
 
@@ -0,0 +1,77 @@
+#ifndef LAZYJSON_ARRAY_READER_HPP
+#define LAZYJSON_ARRAY_READER_HPP
+
+#include "parser.hpp"
+#include "sidecar.hpp"
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace lazyjson {
+
+    enum class ArrayReaderError {
+        NONE,
+        IO_ERROR,
+        NOT_AN_ARRAY,
+        MALFORMED,
+        PARSE_ERROR
+    };
+    std::ostream& operator<<(std::ostream& os, const ArrayReaderError& error);
+
+    // Iterates the elements of a top-level array one at a time.
+    // Only the current element is tokenized and parsed, always by the same Parser
+    // (reset between elements, so its token and node storage is recycled): peak
+    // memory is bounded by the largest element rather than by the whole input.
+    // File input is memory mapped and the pages already consumed are dropped.
+    //
+    //     lazyjson::ArrayReader reader;
+    //     if (reader.openFile("records.json")) {
+    //         while (reader.next()) {
+    //             reader.parser().get("user.id", element);
+    //         }
+    //     }
+    //     if (reader.error() != lazyjson::ArrayReaderError::NONE) ...
+    class ArrayReader {
+    public:
+        ArrayReader() = default;
+
+        // Read a file (memory mapped)
+        bool openFile(const std::string& path);
+        // Read a buffer owned by the caller, valid for the whole iteration
+        bool openBuffer(std::string_view data);
+
+        // Move to the next element; false at the end of the array or on error
+        bool next();
+
+        // Parser holding the current element as its root (scalars included)
+        inline Parser& parser() { return parser_; }
+        inline ElementPtr element() const { return parser_.getRoot(); }
+        // Raw text of the current element
+        inline std::string_view raw() const { return current_; }
+
+        // Position of the current element in the array
+        inline size_t index() const { return index_ - 1; }
+        inline ArrayReaderError error() const { return error_; }
+
+    private:
+        bool start();
+        bool fail(ArrayReaderError error);
+        // End of the value starting at `pos`, or npos if it is not terminated
+        size_t scanValue(size_t pos) const;
+        size_t skipWhitespace(size_t pos) const;
+
+        std::unique_ptr<MappedFile> file_;
+        std::string_view data_;
+        std::string_view current_;
+        size_t pos_ = 0;
+        size_t index_ = 0;
+        size_t discarded_ = 0;
+        bool done_ = true;
+        ArrayReaderError error_ = ArrayReaderError::NONE;
+        Parser parser_;
+    };
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_ARRAY_READER_HPP
@@ -0,0 +1,312 @@
+#ifndef LAZYJSON_BIND_HPP
+#define LAZYJSON_BIND_HPP
+
+#include "parser.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Compile time struct binding.
+//
+//     struct Customer { std::string name; };
+//     struct Order { int64_t id; int qty; double price; Customer customer; };
+//     LAZYJSON_BIND(Customer, name)
+//     LAZYJSON_BIND(Order, id, qty, price, customer)
+//
+//     Order order = lazyjson::extract<Order>(parser);
+//
+// extract() walks the token tape once: every member key is matched against the
+// field names known at compile time and the value is parsed straight into the
+// struct member. Unknown keys are skipped, missing keys keep the member's value,
+// nested paths (customer.name) are expressed with nested bound structs.
+// Supported members: bool, integers, floating point, std::string (unescaped),
+// std::string_view (raw escaped view into the source), std::optional<T>,
+// std::vector<T> and other bound structs. LAZYJSON_BIND must be used in the
+// namespace of the struct, up to 32 fields.
+
+namespace lazyjson {
+
+    template<typename Class, typename Member>
+    struct FieldBinding {
+        std::string_view name;
+        Member Class::* member;
+    };
+
+    template<typename Class, typename Member>
+    constexpr FieldBinding<Class, Member> bindField(std::string_view name, Member Class::* member) {
+        return {name, member};
+    }
+
+    namespace bind_detail {
+
+        // A struct is bound when lazyjson_binding(const T*) is found by ADL
+        template<typename T, typename = void>
+        struct IsBound : std::false_type {};
+        template<typename T>
+        struct IsBound<T, std::void_t<decltype(lazyjson_binding(static_cast<const T*>(nullptr)))>> : std::true_type {};
+
+        template<typename T> struct IsOptional : std::false_type {};
+        template<typename T> struct IsOptional<std::optional<T>> : std::true_type {};
+        template<typename T> struct IsVector : std::false_type {};
+        template<typename T, typename A> struct IsVector<std::vector<T, A>> : std::true_type {};
+
+        [[noreturn]] inline void mismatch(const char* expected, const Token& token) {
+            std::string message = "Binding error: expected ";
+            message.append(expected).append(", found ");
+            message.append(token.type == TokenType::TOKEN_STRING ? "string" : std::string(token.value));
+            throw std::runtime_error(message);
+        }
+
+        // Single pass reader over the token tape
+        class TapeWalker {
+        public:
+            TapeWalker(const std::vector<Token>& tokens, size_t index) : tokens_(tokens), index_(index) {}
+
+            const Token& peek() const {
+                if (index_ >= tokens_.size()) throw std::runtime_error("Unexpected end of tokens");
+                return tokens_[index_];
+            }
+            const Token& next() {
+                const Token& token = peek();
+                index_++;
+                return token;
+            }
+            void expect(TokenType type) {
+                if (next().type != type) throw std::runtime_error("Binding error: malformed document");
+            }
+
+            // Skip the value at the cursor, nested containers included
+            void skip() {
+                size_t depth = 0;
+                do {
+                    switch (next().type) {
+                        case TokenType::TOKEN_OBJECT_START:
+                        case TokenType::TOKEN_ARRAY_START: depth++; break;
+                        case TokenType::TOKEN_OBJECT_END:
+                        case TokenType::TOKEN_ARRAY_END: depth--; break;
+                        default: break;
+                    }
+                } while (depth > 0);
+            }
+
+            // Iterate the members of the object at the cursor: fn(key) must consume the value
+            template<typename Fn>
+            void forEachMember(Fn&& fn) {
+                expect(TokenType::TOKEN_OBJECT_START);
+                if (peek().type == TokenType::TOKEN_OBJECT_END) { index_++; return; }
+                while (true) {
+                    const Token& key = next();
+                    if (key.type != TokenType::TOKEN_STRING) mismatch("object key", key);
+                    expect(TokenType::TOKEN_COLON);
+                    fn(key.value);
+                    const Token& separator = next();
+                    if (separator.type == TokenType::TOKEN_OBJECT_END) return;
+                    if (separator.type != TokenType::TOKEN_COMMA) mismatch("',' or '}'", separator);
+                }
+            }
+
+            // Iterate the elements of the array at the cursor: fn() must consume the value
+            template<typename Fn>
+            void forEachElement(Fn&& fn) {
+                expect(TokenType::TOKEN_ARRAY_START);
+                if (peek().type == TokenType::TOKEN_ARRAY_END) { index_++; return; }
+                while (true) {
+                    fn();
+                    const Token& separator = next();
+                    if (separator.type == TokenType::TOKEN_ARRAY_END) return;
+                    if (separator.type != TokenType::TOKEN_COMMA) mismatch("',' or ']'", separator);
+                }
+            }
+
+        private:
+            const std::vector<Token>& tokens_;
+            size_t index_;
+        };
+
+        template<typename T>
+        void read(TapeWalker& walker, T& out);
+
+        template<typename T, typename Fields, size_t... I>
+        bool dispatch(TapeWalker& walker, std::string_view key, T& out, const Fields& fields, std::index_sequence<I...>) {
+            // Expands to a chain of comparisons against the compile time field names
+            return ((key == std::get<I>(fields).name
+                     ? (read(walker, out.*(std::get<I>(fields).member)), true)
+                     : false) || ...);
+        }
+
+        template<typename T>
+        void readBound(TapeWalker& walker, T& out) {
+            static const auto fields = lazyjson_binding(static_cast<const T*>(nullptr));
+            constexpr size_t count = std::tuple_size<std::decay_t<decltype(fields)>>::value;
+            walker.forEachMember([&](std::string_view key) {
+                if (!dispatch(walker, key, out, fields, std::make_index_sequence<count>{})) {
+                    walker.skip();
+                }
+            });
+        }
+
+        template<typename T>
+        void readNumber(TapeWalker& walker, T& out) {
+            const Token& token = walker.next();
+            if (token.type != TokenType::TOKEN_NUMBER) mismatch("number", token);
+            const char* first = token.value.data();
+            const char* last = first + token.value.size();
+            if constexpr (std::is_floating_point_v<T>) {
+                auto result = std::from_chars(first, last, out);
+                if (result.ec != std::errc() || result.ptr != last) {
+                    // Out of T's range (1e300 for a float: converting is undefined) or a
+                    // spelling from_chars refuses; underflow still rounds towards zero
+                    const std::string text(token.value);
+                    char* end = nullptr;
+                    const long double value = std::strtold(text.c_str(), &end);
+                    if (end != text.c_str() + text.size() || !(std::fabs(value) <= std::numeric_limits<T>::max())) {
+                        mismatch("number in the range of the member", token);
+                    }
+                    out = static_cast<T>(value);
+                }
+            } else {
+                auto result = std::from_chars(first, last, out);
+                if (result.ec != std::errc() || result.ptr != last) {
+                    // Exponent notation or a zero fraction (1e3, 2.0) for an integer member is
+                    // accepted when the value is integral and fits T; anything else (300 for a
+                    // uint8_t, -1 for an unsigned, 1.5) is a mismatch rather than a wrapped value
+                    const double value = std::strtod(std::string(token.value).c_str(), nullptr);
+                    // [min, 2^digits) is exact in a double for every integer type
+                    if (!(value >= static_cast<double>(std::numeric_limits<T>::min())
+                          && value < std::ldexp(1.0, std::numeric_limits<T>::digits)
+                          && value == std::trunc(value))) {
+                        mismatch(std::is_signed_v<T> ? "integer in the range of the member" : "non negative integer in the range of the member", token);
+                    }
+                    out = static_cast<T>(value);
+                }
+            }
+        }
+
+        template<typename T>
+        void read(TapeWalker& walker, T& out) {
+            if constexpr (IsOptional<T>::value) {
+                if (walker.peek().type == TokenType::TOKEN_NULL) {
+                    walker.next();
+                    out.reset();
+                } else {
+                    read(walker, out.emplace());
+                }
+            } else if (walker.peek().type == TokenType::TOKEN_NULL) {
+                // null for a non optional member keeps its current value
+                walker.next();
+            } else if constexpr (std::is_same_v<T, bool>) {
+                const Token& token = walker.next();
+                if (token.type != TokenType::TOKEN_BOOLEAN) mismatch("boolean", token);
+                out = token.value == "true";
+            } else if constexpr (std::is_arithmetic_v<T>) {
+                readNumber(walker, out);
+            } else if constexpr (std::is_same_v<T, std::string>) {
+                const Token& token = walker.next();
+                if (token.type != TokenType::TOKEN_STRING) mismatch("string", token);
+                if (token.value.find('\\') == std::string_view::npos) {
+                    out.assign(token.value.data(), token.value.size());
+                } else if (!unescapeString(token.value, out)) {
+                    throw std::runtime_error("Binding error: invalid escape sequence");
+                }
+            } else if constexpr (std::is_same_v<T, std::string_view>) {
+                const Token& token = walker.next();
+                if (token.type != TokenType::TOKEN_STRING) mismatch("string", token);
+                out = token.value;
+            } else if constexpr (IsVector<T>::value) {
+                out.clear();
+                walker.forEachElement([&] {
+                    read(walker, out.emplace_back());
+                });
+            } else if constexpr (IsBound<T>::value) {
+                readBound(walker, out);
+            } else {
+                static_assert(IsBound<T>::value, "Type is not supported by lazyjson binding (missing LAZYJSON_BIND?)");
+            }
+        }
+
+    } // namespace bind_detail
+
+    // Fill `out` from the element starting at token `token_index` of the parser tape
+    template<typename T>
+    int extract(const Parser& parser, size_t token_index, T& out) {
+        bind_detail::TapeWalker walker(parser.getTokens(), token_index);
+        bind_detail::read(walker, out);
+        return 0;
+    }
+
+    // Fill `out` from an element obtained through Parser::get
+    template<typename T>
+    int extract(const Parser& parser, const DataElement& element, T& out) {
+        return extract(parser, element.getTokenIndexStart(), out);
+    }
+
+    // Build a T from the whole document
+    template<typename T>
+    T extract(const Parser& parser) {
+        T out{};
+        extract(parser, parser.getRoot()->getTokenIndexStart(), out);
+        return out;
+    }
+
+} // namespace lazyjson
+
+#define LAZYJSON_BIND_FIELD_(Type, field) ::lazyjson::bindField(#field, &Type::field)
+
+#define LAZYJSON_BIND_1(T, a) LAZYJSON_BIND_FIELD_(T, a)
+#define LAZYJSON_BIND_2(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_1(T, __VA_ARGS__)
+#define LAZYJSON_BIND_3(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_2(T, __VA_ARGS__)
+#define LAZYJSON_BIND_4(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_3(T, __VA_ARGS__)
+#define LAZYJSON_BIND_5(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_4(T, __VA_ARGS__)
+#define LAZYJSON_BIND_6(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_5(T, __VA_ARGS__)
+#define LAZYJSON_BIND_7(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_6(T, __VA_ARGS__)
+#define LAZYJSON_BIND_8(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_7(T, __VA_ARGS__)
+#define LAZYJSON_BIND_9(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_8(T, __VA_ARGS__)
+#define LAZYJSON_BIND_10(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_9(T, __VA_ARGS__)
+#define LAZYJSON_BIND_11(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_10(T, __VA_ARGS__)
+#define LAZYJSON_BIND_12(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_11(T, __VA_ARGS__)
+#define LAZYJSON_BIND_13(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_12(T, __VA_ARGS__)
+#define LAZYJSON_BIND_14(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_13(T, __VA_ARGS__)
+#define LAZYJSON_BIND_15(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_14(T, __VA_ARGS__)
+#define LAZYJSON_BIND_16(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_15(T, __VA_ARGS__)
+#define LAZYJSON_BIND_17(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_16(T, __VA_ARGS__)
+#define LAZYJSON_BIND_18(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_17(T, __VA_ARGS__)
+#define LAZYJSON_BIND_19(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_18(T, __VA_ARGS__)
+#define LAZYJSON_BIND_20(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_19(T, __VA_ARGS__)
+#define LAZYJSON_BIND_21(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_20(T, __VA_ARGS__)
+#define LAZYJSON_BIND_22(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_21(T, __VA_ARGS__)
+#define LAZYJSON_BIND_23(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_22(T, __VA_ARGS__)
+#define LAZYJSON_BIND_24(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_23(T, __VA_ARGS__)
+#define LAZYJSON_BIND_25(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_24(T, __VA_ARGS__)
+#define LAZYJSON_BIND_26(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_25(T, __VA_ARGS__)
+#define LAZYJSON_BIND_27(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_26(T, __VA_ARGS__)
+#define LAZYJSON_BIND_28(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_27(T, __VA_ARGS__)
+#define LAZYJSON_BIND_29(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_28(T, __VA_ARGS__)
+#define LAZYJSON_BIND_30(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_29(T, __VA_ARGS__)
+#define LAZYJSON_BIND_31(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_30(T, __VA_ARGS__)
+#define LAZYJSON_BIND_32(T, a, ...) LAZYJSON_BIND_FIELD_(T, a), LAZYJSON_BIND_31(T, __VA_ARGS__)
+
+#define LAZYJSON_BIND_SELECT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, \
+                              _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, NAME, ...) NAME
+
+#define LAZYJSON_BIND(Type, ...)                                                                       \
+    inline auto lazyjson_binding(const Type*) {                                                        \
+        return std::make_tuple(LAZYJSON_BIND_SELECT_(__VA_ARGS__,                                      \
+            LAZYJSON_BIND_32, LAZYJSON_BIND_31, LAZYJSON_BIND_30, LAZYJSON_BIND_29, LAZYJSON_BIND_28,  \
+            LAZYJSON_BIND_27, LAZYJSON_BIND_26, LAZYJSON_BIND_25, LAZYJSON_BIND_24, LAZYJSON_BIND_23,  \
+            LAZYJSON_BIND_22, LAZYJSON_BIND_21, LAZYJSON_BIND_20, LAZYJSON_BIND_19, LAZYJSON_BIND_18,  \
+            LAZYJSON_BIND_17, LAZYJSON_BIND_16, LAZYJSON_BIND_15, LAZYJSON_BIND_14, LAZYJSON_BIND_13,  \
+            LAZYJSON_BIND_12, LAZYJSON_BIND_11, LAZYJSON_BIND_10, LAZYJSON_BIND_9, LAZYJSON_BIND_8,    \
+            LAZYJSON_BIND_7, LAZYJSON_BIND_6, LAZYJSON_BIND_5, LAZYJSON_BIND_4, LAZYJSON_BIND_3,       \
+            LAZYJSON_BIND_2, LAZYJSON_BIND_1)(Type, __VA_ARGS__));                                     \
+    }
+
+#endif // LAZYJSON_BIND_HPP
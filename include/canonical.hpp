@@ -0,0 +1,34 @@
+#ifndef LAZYJSON_CANONICAL_HPP
+#define LAZYJSON_CANONICAL_HPP
+
+#include "parser.hpp"
+#include "hash.hpp"
+
+namespace lazyjson {
+
+    // Canonical hashing and equality of JSON values, computed on the token tape.
+    // Two values are canonically equal when they only differ in formatting:
+    // whitespace, object member order, number spelling (1, 1.0 and 1e0 are the
+    // same number; integers compare exactly at any size, fractional numbers as
+    // doubles) and string escapes (compared after decoding). Equal values
+    // always have the same hash, whichever document they come from.
+    //
+    // The hash of an element is memoized on the element, so asking again is O(1).
+    // Memoizing writes to the element: do not hash the same element from
+    // several threads at once.
+
+    // Hash of the subtree of `element`, which belongs to `parser`
+    Hash128 canonicalHash(const Parser& parser, DataElement& element);
+    // Hash of the whole document
+    Hash128 canonicalHash(const Parser& parser);
+    // Hash of the value starting at `token_index` (not memoized)
+    Hash128 canonicalHash(const Parser& parser, size_t token_index);
+
+    // Canonical equality of two subtrees, possibly from different parsers.
+    // Identical byte spans and differing memoized hashes are decided without a walk.
+    bool canonicalEqual(const Parser& a, const DataElement& element_a, const Parser& b, const DataElement& element_b);
+    bool canonicalEqual(const Parser& a, const Parser& b);
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_CANONICAL_HPP
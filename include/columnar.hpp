@@ -0,0 +1,141 @@
+#ifndef LAZYJSON_COLUMNAR_HPP
+#define LAZYJSON_COLUMNAR_HPP
+
+#include "path.hpp"
+#include "tokenizer.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lazyjson {
+
+    enum class ColumnType {
+        BOOLEAN,
+        INT64,
+        DOUBLE,
+        STRING
+    };
+    std::ostream& operator<<(std::ostream& os, const ColumnType& type);
+
+    // One field to extract: `path` uses the Parser::get syntax ("user.id", "tags[0]")
+    struct ColumnSpec {
+        std::string name;
+        std::string path;
+        ColumnType type;
+    };
+
+    // Typed column in the Arrow memory layout: a validity bitmap (bit i of byte
+    // i / 8, least significant first, 1 = valid), then either a contiguous value
+    // array (INT64, DOUBLE), a bit packed value bitmap (BOOLEAN), or 64 bit
+    // offsets into a data buffer (STRING, i.e. Arrow LargeUtf8). Null rows keep a
+    // zero value / empty string so buffers stay aligned with the row number.
+    class Column {
+    public:
+        Column(std::string name, ColumnType type) : name_(std::move(name)), type_(type) {}
+
+        inline const std::string& name() const { return name_; }
+        inline ColumnType type() const { return type_; }
+        inline size_t size() const { return size_; }
+        inline size_t nullCount() const { return null_count_; }
+
+        inline bool isValid(size_t row) const { return (validity_[row >> 3] >> (row & 7)) & 1; }
+        inline const std::vector<uint8_t>& validity() const { return validity_; }
+
+        inline const std::vector<int64_t>& int64Values() const { return int64_values_; }
+        inline const std::vector<double>& doubleValues() const { return double_values_; }
+        inline const std::vector<uint8_t>& booleanValues() const { return boolean_values_; }
+        inline bool booleanValue(size_t row) const { return (boolean_values_[row >> 3] >> (row & 7)) & 1; }
+        inline const std::vector<int64_t>& offsets() const { return offsets_; }
+        inline const std::string& data() const { return data_; }
+        inline std::string_view stringValue(size_t row) const {
+            return std::string_view(data_).substr(static_cast<size_t>(offsets_[row]), static_cast<size_t>(offsets_[row + 1] - offsets_[row]));
+        }
+
+        // Builders (one call per row)
+        void appendNull();
+        void appendBoolean(bool value);
+        void appendInt64(int64_t value);
+        void appendDouble(double value);
+        void appendString(std::string_view value);
+        // Rows of another column of the same type, after the rows of this one
+        void append(const Column& other);
+
+        void reserve(size_t rows);
+        void clear();
+
+    private:
+        void pushValidity(bool valid);
+
+        std::string name_;
+        ColumnType type_;
+        size_t size_ = 0;
+        size_t null_count_ = 0;
+        std::vector<uint8_t> validity_;
+        std::vector<int64_t> int64_values_;
+        std::vector<double> double_values_;
+        std::vector<uint8_t> boolean_values_;
+        std::vector<int64_t> offsets_ = {0};
+        std::string data_;
+    };
+
+    // Fills typed columns from NDJSON records (one JSON document per line).
+    // The paths of all columns are merged into a trie, so each record is walked
+    // once: members that no path goes through are skipped over on the token tape
+    // and nothing is materialized. A value of the wrong type, or a missing one,
+    // gives a null. The input is cut into contiguous batches of lines processed
+    // by separate threads, each with its own tokenizer and partial columns, which
+    // are then appended in order (row order is the input order).
+    //
+    //     lazyjson::ColumnarExtractor extractor({
+    //         {"ts", "timestamp", lazyjson::ColumnType::STRING},
+    //         {"user", "user.id", lazyjson::ColumnType::INT64},
+    //         {"amount", "amount", lazyjson::ColumnType::DOUBLE}});
+    //     extractor.extract(ndjson, 8);
+    //     const auto& amounts = extractor.column(2).doubleValues();
+    class ColumnarExtractor {
+    public:
+        // Throws std::runtime_error on an invalid path ("[*]" is not supported)
+        explicit ColumnarExtractor(std::vector<ColumnSpec> specs);
+        // The trie views the strings of specs_: movable, not copyable
+        ColumnarExtractor(const ColumnarExtractor&) = delete;
+        ColumnarExtractor& operator=(const ColumnarExtractor&) = delete;
+        ColumnarExtractor(ColumnarExtractor&&) = default;
+        ColumnarExtractor& operator=(ColumnarExtractor&&) = default;
+
+        // Append the records of `ndjson`; threads == 0 uses every hardware thread.
+        // Returns the number of records appended.
+        size_t extract(std::string_view ndjson, size_t threads = 1);
+
+        inline const std::vector<Column>& columns() const { return columns_; }
+        inline const Column& column(size_t i) const { return columns_[i]; }
+        inline size_t rows() const { return columns_.empty() ? rows_ : columns_.front().size(); }
+        // Lines that could not be tokenized or are not well formed (all-null rows)
+        inline size_t malformedRecords() const { return malformed_; }
+
+        void clear();
+
+    private:
+        struct TrieNode {
+            std::string_view key;
+            size_t index = Path::kNoIndex;  // array position, kNoIndex for a key
+            int column = -1;
+            std::vector<uint32_t> children;
+        };
+
+        struct Batch;
+        // Rows for the lines of `input`
+        void extractBatch(std::string_view input, Batch& batch) const;
+        bool walk(const std::vector<Token>& tokens, size_t& index, uint32_t node, std::vector<size_t>& hits) const;
+
+        std::vector<ColumnSpec> specs_;  // owns the strings the paths and trie view
+        std::vector<TrieNode> trie_;     // trie_[0] is the record root
+        std::vector<Column> columns_;
+        size_t rows_ = 0;
+        size_t malformed_ = 0;
+    };
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_COLUMNAR_HPP
@@ -2,6 +2,9 @@
 #define LAZYJSON_DATA_HPP
 
 #include "tokenizer.hpp"
+#include "element_ptr.hpp"
+#include "hash.hpp"
+#include "shape.hpp"
 #include <memory>
 #include <string>
 #include <string_view>
@@ -11,6 +14,7 @@
 #include <functional> 
 #include <iostream>
 #include <queue>
+#include <stdexcept>
 #include <unordered_set>
 
 namespace lazyjson {
@@ -32,7 +36,12 @@ namespace lazyjson {
     };
     std::ostream& operator<<(std::ostream& os, const ElementType& type);
 
-    class DataElement {
+    // JSON string escaping helpers (string token values are kept escaped, without quotes)
+    std::string escapeString(std::string_view str);
+    // Decodes escapes (including \uXXXX surrogate pairs, to UTF-8) into `out`; false on malformed input
+    bool unescapeString(std::string_view escaped, std::string& out);
+
+    class DataElement : public RefCounted {
         public:
             
             DataElement() : 
@@ -53,6 +62,10 @@ namespace lazyjson {
                 materialized_element_list_.clear();
                 token_index_list_.clear();
                 key_ordered_list_.clear();
+                shape_.reset();
+                slot_token_index_.clear();
+                detached_shapes_.clear();
+                has_canonical_hash_ = false;
                 is_materialized_ = false;
                 is_modified_ = false;
                 type_ = ElementType::NULL_VALUE;
@@ -68,6 +81,11 @@ namespace lazyjson {
                         
             inline bool isMaterialized() const { return is_materialized_; }
             inline void setIsMaterialized(bool is_materialized) { is_materialized_ = is_materialized; }
+            // Memoized canonical hash of the subtree (see canonical.hpp)
+            inline bool hasCanonicalHash() const { return has_canonical_hash_; }
+            inline const Hash128& getCanonicalHash() const { return canonical_hash_; }
+            inline void setCanonicalHash(const Hash128& hash) { canonical_hash_ = hash; has_canonical_hash_ = true; }
+
             inline bool isModified() const { return is_modified_; }
             inline void setIsModified(bool is_modified) { is_modified_ = is_modified; }
 
@@ -82,17 +100,44 @@ namespace lazyjson {
             DataNumber asNumber() const { return std::get<DataNumber>(materialized_value_); }
             const DataString& asString() const { return std::get<DataString>(materialized_value_); }
             
-            inline const std::vector<std::string_view>& getElementKeyList() const { return key_ordered_list_; }
+            inline const std::vector<std::string_view>& getElementKeyList() const { return shape_ ? shape_->keys() : key_ordered_list_; }
             
-            inline bool isTokenIndexRegistered(const std::string_view key) const { return token_index_list_.find(key) != token_index_list_.end(); }
-            inline const size_t& getTokenIndex(const std::string_view& key) const { return token_index_list_.at(key); }
-            inline const std::unordered_map<std::string_view, size_t>& getTokenIndexList() const { return token_index_list_; }
+            inline bool isTokenIndexRegistered(const std::string_view key) const {
+                if (shape_) return shape_->slot(key) != Shape::kNoSlot;
+                return token_index_list_.find(key) != token_index_list_.end();
+            }
+            inline const size_t& getTokenIndex(const std::string_view& key) const {
+                if (shape_) {
+                    const size_t slot = shape_->slot(key);
+                    if (slot == Shape::kNoSlot) throw std::out_of_range("Key not registered");
+                    return slot_token_index_[slot];
+                }
+                return token_index_list_.at(key);
+            }
+            // Single lookup, no exception: false when `key` is not registered
+            inline bool findTokenIndex(const std::string_view key, size_t& index) const {
+                if (shape_) {
+                    const size_t slot = shape_->slot(key);
+                    if (slot == Shape::kNoSlot) return false;
+                    index = slot_token_index_[slot];
+                    return true;
+                }
+                auto it = token_index_list_.find(key);
+                if (it == token_index_list_.end()) return false;
+                index = it->second;
+                return true;
+            }
             inline void addTokenIndex(const std::string_view key, const size_t index) { 
+                if (shape_) detachShape();
                 if(token_index_list_.emplace(key, index).second){
                     key_ordered_list_.push_back(key);
                 } 
             }
             inline const std::string_view getTokenStringView(const std::string_view key) { 
+                if (shape_) {
+                    const size_t slot = shape_->slot(key);
+                    return slot == Shape::kNoSlot ? std::string_view{} : shape_->key(slot);
+                }
                 auto it = token_index_list_.find(key);
                 if (it != token_index_list_.end()) {
                     return it->first;
@@ -100,10 +145,56 @@ namespace lazyjson {
                 return {};
             }
 
+            // Calls fn(key, token_index) for every registered key
+            template<typename Fn>
+            void forEachTokenIndex(Fn&& fn) const {
+                if (shape_) {
+                    for (size_t slot = 0; slot < slot_token_index_.size(); slot++) {
+                        fn(shape_->key(slot), slot_token_index_[slot]);
+                    }
+                } else {
+                    for (const auto& [key, index] : token_index_list_) {
+                        fn(key, index);
+                    }
+                }
+            }
+
+            // Shared key layout (see shape.hpp): slot i of `token_indexes` holds the
+            // token index of shape->key(i). Replaces any registered key.
+            inline void setShape(std::shared_ptr<const Shape> shape, std::vector<size_t>&& token_indexes) {
+                token_index_list_.clear();
+                key_ordered_list_.clear();
+                shape_ = std::move(shape);
+                slot_token_index_ = std::move(token_indexes);
+                slot_children_.clear();
+            }
+            inline const std::shared_ptr<const Shape>& getShape() const { return shape_; }
+            inline size_t getSlotTokenIndex(size_t slot) const { return slot_token_index_[slot]; }
+            // Materialized child of a shape slot, nullptr when not materialized yet
+            inline const ElementPtr* getMaterializedSlot(size_t slot) const {
+                return slot < slot_children_.size() ? slot_children_[slot] : nullptr;
+            }
+
             inline const bool isMaterializedElement(const std::string_view& key) const { return materialized_element_list_.find(key) != materialized_element_list_.end(); }
-            inline const std::shared_ptr<DataElement> getMaterializedElement(const std::string_view& key) const { return materialized_element_list_.at(key); }
-            inline const std::unordered_map<std::string_view, std::shared_ptr<lazyjson::DataElement>> getMaterializedElementList() const { return materialized_element_list_; }
-            inline void addMaterializedElement(const std::string_view& key, std::shared_ptr<DataElement> value_ptr) { materialized_element_list_.emplace(key, value_ptr); }
+            inline const ElementPtr getMaterializedElement(const std::string_view& key) const { return materialized_element_list_.at(key); }
+            // nullptr when `key` has no materialized child
+            inline const ElementPtr* findMaterializedElement(const std::string_view& key) const {
+                auto it = materialized_element_list_.find(key);
+                return it == materialized_element_list_.end() ? nullptr : &it->second;
+            }
+            inline const std::unordered_map<std::string_view, ElementPtr>& getMaterializedElementList() const { return materialized_element_list_; }
+            inline void addMaterializedElement(const std::string_view& key, ElementPtr value_ptr) {
+                auto inserted = materialized_element_list_.emplace(key, value_ptr);
+                // Slot lookups are only used by resolved paths, i.e. with interned shapes
+                if (shape_ && shape_->interner() && inserted.second) {
+                    const size_t slot = shape_->slot(key);
+                    if (slot != Shape::kNoSlot) {
+                        if (slot_children_.size() < shape_->size()) slot_children_.resize(shape_->size(), nullptr);
+                        // Map nodes never move, the pointer stays valid until the map is cleared
+                        slot_children_[slot] = &inserted.first->second;
+                    }
+                }
+            }
 
         private:
 
@@ -113,44 +204,69 @@ namespace lazyjson {
 
             bool is_materialized_;
             bool is_modified_;
+            bool has_canonical_hash_ = false;
+            Hash128 canonical_hash_;
 
             PrimitiveType materialized_value_;
 
             std::vector<std::string_view> key_ordered_list_;
             std::unordered_map<std::string_view, size_t> token_index_list_;
-            std::unordered_map<std::string_view, std::shared_ptr<DataElement>> materialized_element_list_;
+            std::unordered_map<std::string_view, ElementPtr> materialized_element_list_;
+
+            // Set instead of the two members above when the keys follow a cached shape
+            std::shared_ptr<const Shape> shape_;
+            std::vector<size_t> slot_token_index_;
+            std::vector<const ElementPtr*> slot_children_;
+
+            // Move the shaped keys to the per-object map, before adding a key
+            void detachShape() {
+                std::shared_ptr<const Shape> shape = std::move(shape_);
+                shape_.reset();
+                for (size_t slot = 0; slot < shape->size(); slot++) {
+                    token_index_list_.emplace(shape->key(slot), slot_token_index_[slot]);
+                    key_ordered_list_.push_back(shape->key(slot));
+                }
+                slot_token_index_.clear();
+                slot_children_.clear();
+                // Keep the shape alive: registered and materialized keys still view its storage
+                detached_shapes_.push_back(std::move(shape));
+            }
+            std::vector<std::shared_ptr<const Shape>> detached_shapes_;
 
             void destroyRecursively() {
                 if (materialized_element_list_.empty()) {
                     return;
                 }
 
-                // Usa una coda per attraversare iterativamente la struttura
-                std::queue<std::unordered_map<std::string_view, std::shared_ptr<DataElement>>*> toProcess;
-                toProcess.push(&materialized_element_list_);
+                // Usa uno stack per attraversare iterativamente la struttura:
+                // i figli vengono staccati dal padre prima che questo venga distrutto,
+                // cosi' nessun distruttore ricorsivo parte su alberi profondi
+                std::vector<ElementPtr> toProcess;
+                for (auto& [key, element] : materialized_element_list_) {
+                    toProcess.push_back(std::move(element));
+                }
+                materialized_element_list_.clear();
+                slot_children_.clear();
 
                 while (!toProcess.empty()) {
-                    auto* currentMap = toProcess.front();
-                    toProcess.pop();
-
-                    for (auto& [key, element] : *currentMap) {
-                        if (element && element.use_count() == 1) {
-                            // Se siamo gli unici proprietari, aggiungi i figli alla coda
-                            if (!element->materialized_element_list_.empty()) {
-                                toProcess.push(&element->materialized_element_list_);
-                            }
+                    ElementPtr element = std::move(toProcess.back());
+                    toProcess.pop_back();
+
+                    if (element && element.use_count() == 1) {
+                        // Se siamo gli unici proprietari, aggiungi i figli allo stack
+                        for (auto& [key, child] : element->materialized_element_list_) {
+                            toProcess.push_back(std::move(child));
                         }
+                        element->materialized_element_list_.clear();
+                        element->slot_children_.clear();
                     }
-                    
-                    // Svuota la mappa corrente
-                    currentMap->clear();
                 }
             }
     };
 
     class DataElementManager {
         public:
-            static void safeDestroy(std::shared_ptr<DataElement>& element) {
+            static void safeDestroy(ElementPtr& element) {
                 if (!element) return;
                 
                 // Se siamo gli unici proprietari, forziamo la pulizia
@@ -160,7 +276,7 @@ namespace lazyjson {
                 element.reset();
             }
     
-            static void clearAll(std::vector<std::shared_ptr<DataElement>>& elements) {
+            static void clearAll(std::vector<ElementPtr>& elements) {
                 for (auto& element : elements) {
                     safeDestroy(element);
                 }
@@ -168,7 +284,7 @@ namespace lazyjson {
             }
     
             // Metodo per verificare se ci sono riferimenti circolari (debugging)
-            static bool hasCircularReference(const std::shared_ptr<DataElement>& root) {
+            static bool hasCircularReference(const ElementPtr& root) {
                 if (!root) return false;
                 
                 std::unordered_set<const DataElement*> visited;
@@ -0,0 +1,39 @@
+#ifndef LAZYJSON_DIFF_HPP
+#define LAZYJSON_DIFF_HPP
+
+#include "parser.hpp"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace lazyjson {
+
+    enum class PatchOp {
+        ADD,
+        REMOVE,
+        REPLACE
+    };
+    std::ostream& operator<<(std::ostream& os, const PatchOp& op);
+
+    // One RFC 6902 operation
+    struct PatchOperation {
+        PatchOp op;
+        std::string path;   // JSON pointer
+        std::string value;  // Raw JSON text of the new value (empty for REMOVE)
+    };
+
+    // Operations turning the document of `from` into the document of `to`.
+    // Both token tapes are walked in step: at every level the raw bytes of the two
+    // values are compared first and identical subtrees are skipped whole, so no
+    // DataElement is created and unchanged regions are never descended into.
+    // Values that only differ in formatting (whitespace, number or escape
+    // spelling) produce no operation. Array elements are compared by position;
+    // removals are emitted from the highest index down so they apply in order.
+    std::vector<PatchOperation> diff(const Parser& from, const Parser& to);
+
+    // Serialize operations as a JSON Patch document
+    std::string toJsonPatch(const std::vector<PatchOperation>& operations);
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_DIFF_HPP
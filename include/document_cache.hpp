@@ -0,0 +1,117 @@
+#ifndef LAZYJSON_DOCUMENT_CACHE_HPP
+#define LAZYJSON_DOCUMENT_CACHE_HPP
+
+#include "parser.hpp"
+#include "sharded_cache.hpp"
+#include "value_view.hpp"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace lazyjson {
+
+    // Parsed document owned by a DocumentCache and shared, read-only, by every
+    // request that sent the same bytes. It keeps its own copy of the input, the
+    // token tape with its jump table, and the first level registered by parse().
+    //
+    // root() and find() only read the tape and may run on any number of threads
+    // at once. get() materializes elements inside the parser, so calls are
+    // serialized on the document; the ElementPtr it returns is shared between
+    // threads too, which needs the shared or intrusive_atomic handle build.
+    class CachedDocument {
+    public:
+        CachedDocument(const CachedDocument&) = delete;
+        CachedDocument& operator=(const CachedDocument&) = delete;
+
+        inline std::string_view source() const { return source_; }
+        inline uint64_t hash() const { return hash_; }
+        inline const Parser& parser() const { return parser_; }
+        inline ValueView root() const { return ValueView(parser_); }
+
+        // Value at `path` ("a.b[3].c"), resolved on the tape; an invalid view when
+        // missing. Resolutions are memoized per document when the cache enables it.
+        ValueView find(std::string_view path) const;
+
+        // Same as Parser::get
+        int get(const std::string& path, ElementPtr& element) const;
+
+        // Memory charged to the cache for this document
+        size_t bytes() const;
+
+    private:
+        friend class DocumentCache;
+        CachedDocument(std::string_view source, uint64_t hash, size_t max_memo_entries,
+                       std::shared_ptr<ShapeCache> shape_cache);
+
+        // Token index of the value at `path`, 0 when missing
+        size_t resolve(std::string_view path) const;
+
+        std::string source_;
+        uint64_t hash_;
+        size_t max_memo_entries_;
+
+        mutable std::mutex mutex_;
+        mutable Parser parser_;
+        // Path hash -> (path, token index)
+        mutable std::unordered_map<uint64_t, std::pair<std::string, size_t>> memo_;
+    };
+
+    // Content addressed cache of parsed documents. Many inbound payloads are
+    // byte for byte repetitions (config pushes, replayed events): acquire() hashes
+    // the input and, on a hit, returns the document parsed the first time those
+    // bytes were seen instead of parsing them again.
+    //
+    //     lazyjson::DocumentCache cache;
+    //     auto document = cache.acquire(body);   // nullptr: not valid JSON
+    //     if (document) use(document->find("order.total").asNumber());
+    //
+    // Documents are evicted by a ShardedCache bounded in bytes (input, tape and
+    // parser memory); a document stays alive while a request still holds it.
+    // Thread safe.
+    class DocumentCache {
+    public:
+        struct Options {
+            // Memory held by the cached documents
+            size_t capacity_bytes = 64 * 1024 * 1024;
+            // Shards of the underlying ShardedCache (0: sized on the hardware threads)
+            size_t shards = 0;
+            // Compare the input with the cached bytes on a hit. Without it a hit
+            // trusts the 64 bit hash and the length alone: one pass instead of
+            // two, but a crafted collision would be served another document.
+            bool verify_bytes = true;
+            // Paths memoized by each document's find() (0 disables the memo)
+            size_t max_memo_entries = 256;
+            // Inputs smaller than this are parsed without going through the cache
+            size_t min_document_bytes = 0;
+            // Shape cache of the documents' parsers (nullptr: one shared by the cache)
+            std::shared_ptr<ShapeCache> shape_cache;
+        };
+
+        using DocumentPtr = std::shared_ptr<const CachedDocument>;
+
+        DocumentCache();
+        explicit DocumentCache(Options options);
+
+        // Document for the bytes of `json`, parsed and cached on a miss; nullptr
+        // when the input is not valid JSON (invalid inputs are not cached)
+        DocumentPtr acquire(std::string_view json);
+        // Cached document only, nullptr on a miss
+        DocumentPtr find(std::string_view json) const;
+
+        void clear();
+        CacheStats stats() const;
+        inline const Options& options() const { return options_; }
+
+    private:
+        DocumentPtr lookup(std::string_view json, uint64_t hash) const;
+
+        Options options_;
+        mutable ShardedCache<DocumentPtr> cache_;
+    };
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_DOCUMENT_CACHE_HPP
@@ -0,0 +1,118 @@
+#ifndef LAZYJSON_ELEMENT_PTR_HPP
+#define LAZYJSON_ELEMENT_PTR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#if defined(LAZYJSON_INTRUSIVE_PTR_ATOMIC)
+#include <atomic>
+#endif
+
+namespace lazyjson {
+
+    class DataElement;
+
+    // Handle type of DataElement, selected at build time (LAZYJSON_ELEMENT_PTR in CMake):
+    //   shared            std::shared_ptr (default): atomic counts in a separate control block
+    //   intrusive         count embedded in the element, plain increments: elements,
+    //                     and the handles to them, must stay on one thread
+    //   intrusive_atomic  count embedded in the element, atomic increments
+    // The intrusive variants save the control block allocation and, in the
+    // non atomic one, every locked RMW on handle copies (one per get() step).
+    // Code using ElementPtr, makeElement() and the shared_ptr-like members
+    // (get, reset, use_count, ->, *, bool) builds with all three.
+
+#if defined(LAZYJSON_INTRUSIVE_PTR) || defined(LAZYJSON_INTRUSIVE_PTR_ATOMIC)
+
+    template<typename T> class IntrusivePtr;
+
+    // Base of intrusively counted types
+    class RefCounted {
+    protected:
+        RefCounted() = default;
+        // A copied element starts unowned
+        RefCounted(const RefCounted&) {}
+        RefCounted& operator=(const RefCounted&) { return *this; }
+
+    private:
+        template<typename T> friend class IntrusivePtr;
+#if defined(LAZYJSON_INTRUSIVE_PTR_ATOMIC)
+        mutable std::atomic<uint32_t> refs_{0};
+        inline void addRef() const { refs_.fetch_add(1, std::memory_order_relaxed); }
+        inline bool release() const { return refs_.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+        inline long count() const { return static_cast<long>(refs_.load(std::memory_order_relaxed)); }
+#else
+        mutable uint32_t refs_ = 0;
+        inline void addRef() const { ++refs_; }
+        inline bool release() const { return --refs_ == 0; }
+        inline long count() const { return static_cast<long>(refs_); }
+#endif
+    };
+
+    template<typename T>
+    class IntrusivePtr {
+    public:
+        constexpr IntrusivePtr() noexcept = default;
+        constexpr IntrusivePtr(std::nullptr_t) noexcept {}
+        explicit IntrusivePtr(T* ptr) noexcept : ptr_(ptr) { if (ptr_) ptr_->addRef(); }
+        IntrusivePtr(const IntrusivePtr& other) noexcept : ptr_(other.ptr_) { if (ptr_) ptr_->addRef(); }
+        IntrusivePtr(IntrusivePtr&& other) noexcept : ptr_(other.ptr_) { other.ptr_ = nullptr; }
+        ~IntrusivePtr() { if (ptr_ && ptr_->release()) delete ptr_; }
+
+        IntrusivePtr& operator=(const IntrusivePtr& other) noexcept {
+            IntrusivePtr(other).swap(*this);
+            return *this;
+        }
+        IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+            IntrusivePtr(std::move(other)).swap(*this);
+            return *this;
+        }
+        IntrusivePtr& operator=(std::nullptr_t) noexcept {
+            reset();
+            return *this;
+        }
+
+        inline void reset() noexcept { IntrusivePtr().swap(*this); }
+        inline void swap(IntrusivePtr& other) noexcept { std::swap(ptr_, other.ptr_); }
+
+        inline T* get() const noexcept { return ptr_; }
+        inline T& operator*() const noexcept { return *ptr_; }
+        inline T* operator->() const noexcept { return ptr_; }
+        inline explicit operator bool() const noexcept { return ptr_ != nullptr; }
+        inline long use_count() const noexcept { return ptr_ ? ptr_->count() : 0; }
+
+        inline bool operator==(const IntrusivePtr& other) const noexcept { return ptr_ == other.ptr_; }
+        inline bool operator!=(const IntrusivePtr& other) const noexcept { return ptr_ != other.ptr_; }
+        inline bool operator==(std::nullptr_t) const noexcept { return ptr_ == nullptr; }
+        inline bool operator!=(std::nullptr_t) const noexcept { return ptr_ != nullptr; }
+
+    private:
+        T* ptr_ = nullptr;
+    };
+
+    using ElementPtr = IntrusivePtr<DataElement>;
+
+    // T is only a template parameter so that DataElement may still be incomplete here
+    template<typename T = DataElement, typename... Args>
+    inline ElementPtr makeElement(Args&&... args) {
+        return ElementPtr(new T(std::forward<Args>(args)...));
+    }
+
+#else
+
+    // No embedded count: empty base, no storage
+    class RefCounted {};
+
+    using ElementPtr = std::shared_ptr<DataElement>;
+
+    template<typename T = DataElement, typename... Args>
+    inline ElementPtr makeElement(Args&&... args) {
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+
+#endif
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_ELEMENT_PTR_HPP
@@ -0,0 +1,61 @@
+#ifndef LAZYJSON_ERROR_HPP
+#define LAZYJSON_ERROR_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <utility>
+
+namespace lazyjson {
+
+    enum class ErrorKind {
+        NONE,
+        UNTERMINATED_STRING,    // A string runs to the end of the input
+        UNEXPECTED_CHARACTER,   // A byte that cannot start a token
+        UNEXPECTED_TOKEN,       // Tokens in the wrong order (missing ':', stray ']', ...)
+        UNEXPECTED_END,         // The input ends inside a value
+        IO_ERROR,               // load(): the file cannot be mapped
+        INVALID_PATH,           // Unterminated '[' in a path expression
+        KEY_NOT_FOUND,          // Missing key or index
+        NOT_A_CONTAINER,        // A path goes through a scalar
+    };
+    std::ostream& operator<<(std::ostream& os, const ErrorKind& kind);
+
+    // What went wrong and where: the byte offset in the source of the token
+    // where parsing stopped, or of the value a lookup could not go through
+    struct Error {
+        ErrorKind kind = ErrorKind::NONE;
+        size_t offset = 0;
+
+        inline explicit operator bool() const noexcept { return kind != ErrorKind::NONE; }
+    };
+    std::ostream& operator<<(std::ostream& os, const Error& error);
+
+    // Result of the exception-free API: a value or an Error, never both.
+    // T must be default constructible (the value of a failed result).
+    //
+    //     auto price = parser.find("items[3].price");
+    //     if (!price) return price.error();
+    //     total += price->asNumber();
+    template<typename T>
+    class Expected {
+    public:
+        Expected(T value) noexcept : value_(std::move(value)) {}
+        Expected(Error error) noexcept : error_(error) {}
+
+        inline bool hasValue() const noexcept { return error_.kind == ErrorKind::NONE; }
+        inline explicit operator bool() const noexcept { return hasValue(); }
+
+        // Default constructed when there is an error (not checked)
+        inline const T& value() const noexcept { return value_; }
+        inline const T& operator*() const noexcept { return value_; }
+        inline const T* operator->() const noexcept { return &value_; }
+        inline const Error& error() const noexcept { return error_; }
+
+    private:
+        T value_{};
+        Error error_;
+    };
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_ERROR_HPP
@@ -0,0 +1,67 @@
+#ifndef LAZYJSON_EXPORTER_HPP
+#define LAZYJSON_EXPORTER_HPP
+
+#include "parser.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lazyjson {
+
+    enum class BinaryFormat {
+        MESSAGEPACK,
+        CBOR
+    };
+
+    // Receives the encoded bytes in chunks, in order
+    using ByteSink = std::function<void(const uint8_t*, size_t)>;
+
+    // Converts a parsed document to MessagePack or CBOR.
+    // Unmodified subtrees are encoded with a single linear pass over the token
+    // tape: numbers are parsed and string escapes decoded on the fly, and no
+    // DataElement is created. Modified elements (as in Parser::dump) are encoded
+    // from their materialized values.
+    class BinaryExporter {
+    public:
+        explicit BinaryExporter(BinaryFormat format) : format_(format) {}
+
+        // Encode the whole document, appending to `out`
+        int exportDocument(const Parser& parser, std::vector<uint8_t>& out);
+
+        // Encode the whole document into a sink, flushed every `chunk_size` bytes
+        int exportDocument(const Parser& parser, const ByteSink& sink, size_t chunk_size = 65536);
+
+    private:
+        void encodeDocument(const Parser& parser);
+        void encodeElement(const Parser& parser, const DataElement& element);
+        void encodeTokens(const std::vector<Token>& tokens, size_t start);
+
+        void countChildren(const std::vector<Token>& tokens);
+
+        void writeNull();
+        void writeBoolean(bool value);
+        void writeNumber(std::string_view text);
+        void writeDouble(double value);
+        void writeInteger(int64_t value);
+        void writeUnsigned(uint64_t value);
+        void writeString(std::string_view json_escaped);
+        void writeArrayHeader(size_t size);
+        void writeMapHeader(size_t size);
+        void writeHeader(uint8_t major, uint64_t value);
+        void flushIfNeeded();
+
+        BinaryFormat format_;
+        std::vector<uint8_t>* out_ = nullptr;
+        const ByteSink* sink_ = nullptr;
+        size_t chunk_size_ = 0;
+
+        // Number of direct children of every container token, indexed by token
+        std::vector<uint32_t> child_count_;
+        // Scratch space for strings containing escapes
+        std::string unescaped_;
+    };
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_EXPORTER_HPP
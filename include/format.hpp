@@ -0,0 +1,38 @@
+#ifndef LAZYJSON_FORMAT_HPP
+#define LAZYJSON_FORMAT_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace lazyjson {
+
+    // Re-emit JSON text compacted or indented, straight from the input bytes:
+    // no tokenizer, no token vector, no DataElement.
+    // minify() classifies 64 byte blocks at once (SSE2 compares, or 8 byte SWAR
+    // words elsewhere) into quote, backslash and whitespace bit masks, derives
+    // the bytes inside strings with a prefix xor of the unescaped quotes, and
+    // copies the runs between dropped whitespace; blocks with nothing to drop
+    // are copied whole. prettify() has to stop at every structural character
+    // and scans the runs in between 8 bytes at a time.
+    //
+    // The input is not validated. Valid JSON comes out as equivalent JSON;
+    // malformed input comes out malformed, but never makes the functions read or
+    // write out of bounds. Several top-level values (NDJSON) stay on separate
+    // lines: a newline between them is kept as a single '\n'.
+
+    // Compact `json` into `out`, which must hold json.size() bytes (the output
+    // is never longer) and must not overlap the input. Returns the bytes written.
+    size_t minify(std::string_view json, char* out);
+    std::string minify(std::string_view json);
+
+    // Indent `json` with `indent` spaces per level into `out` (at most `capacity`
+    // bytes). Returns the length of the whole output, like snprintf: when it is
+    // larger than `capacity` the output was truncated and the call can be
+    // repeated with a large enough buffer.
+    size_t prettify(std::string_view json, char* out, size_t capacity, unsigned indent = 2);
+    std::string prettify(std::string_view json, unsigned indent = 2);
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_FORMAT_HPP
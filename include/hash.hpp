@@ -0,0 +1,99 @@
+#ifndef LAZYJSON_HASH_HPP
+#define LAZYJSON_HASH_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace lazyjson {
+
+    // Fast non cryptographic 64 bit hash of a byte range.
+    // Four independent lanes consume 32 bytes per iteration (xxHash64 style), so
+    // large inputs hash at several GB/s; it is used to fingerprint whole documents
+    // and therefore must be stable across runs and processes (no random seed).
+    namespace hash_detail {
+        constexpr uint64_t P1 = 0x9E3779B185EBCA87ULL;
+        constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+        constexpr uint64_t P3 = 0x165667B19E3779F9ULL;
+        constexpr uint64_t P4 = 0x85EBCA77C2B2AE63ULL;
+        constexpr uint64_t P5 = 0x27D4EB2F165667C5ULL;
+
+        inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+        inline uint64_t load64(const unsigned char* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+        inline uint64_t round(uint64_t acc, uint64_t input) { return rotl(acc + input * P2, 31) * P1; }
+        inline uint64_t merge(uint64_t acc, uint64_t lane) { return (acc ^ round(0, lane)) * P1 + P4; }
+    }
+
+    inline uint64_t hashMix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDULL;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0) {
+        using namespace hash_detail;
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        const size_t total = size;
+        uint64_t acc;
+
+        if (size >= 32) {
+            uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+            do {
+                v1 = round(v1, load64(p));
+                v2 = round(v2, load64(p + 8));
+                v3 = round(v3, load64(p + 16));
+                v4 = round(v4, load64(p + 24));
+                p += 32;
+                size -= 32;
+            } while (size >= 32);
+            acc = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            acc = merge(merge(merge(merge(acc, v1), v2), v3), v4);
+        } else {
+            acc = seed + P5;
+        }
+
+        acc += total;
+        while (size >= 8) {
+            acc ^= round(0, load64(p));
+            acc = rotl(acc, 27) * P1 + P4;
+            p += 8;
+            size -= 8;
+        }
+        if (size > 0) {
+            uint64_t tail = 0;
+            std::memcpy(&tail, p, size);
+            acc ^= round(0, tail);
+            acc = rotl(acc, 27) * P1 + P4;
+        }
+        return hashMix(acc);
+    }
+
+    inline uint64_t hashBytes(std::string_view bytes, uint64_t seed = 0) {
+        return hashBytes(bytes.data(), bytes.size(), seed);
+    }
+
+    // 128 bit hash as two independent 64 bit lanes
+    struct Hash128 {
+        uint64_t low = 0;
+        uint64_t high = 0;
+
+        inline bool operator==(const Hash128& other) const { return low == other.low && high == other.high; }
+        inline bool operator!=(const Hash128& other) const { return !(*this == other); }
+    };
+
+    // FNV-1a hash of a short key, usable in constant expressions (path literals)
+    constexpr uint64_t hashKey(std::string_view key) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (char c : key) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001B3ULL;
+        }
+        return hash;
+    }
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_HASH_HPP
@@ -0,0 +1,71 @@
+#ifndef LAZYJSON_KEY_INTERNER_HPP
+#define LAZYJSON_KEY_INTERNER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace lazyjson {
+
+    using KeyId = uint32_t;
+    constexpr KeyId kNoKeyId = static_cast<KeyId>(-1);
+
+    // Table mapping key bytes to stable integer ids, meant to be shared by every
+    // parser of a process. Lookups are lock free (an open addressing table of
+    // atomic pointers to immutable entries); inserts are serialized by a mutex.
+    // Entries are never removed, so the table has a fixed capacity: once it is
+    // full intern() returns kNoKeyId and callers fall back to string keys.
+    class KeyInterner {
+    public:
+        explicit KeyInterner(size_t max_keys = 32768);
+        ~KeyInterner();
+
+        KeyInterner(const KeyInterner&) = delete;
+        KeyInterner& operator=(const KeyInterner&) = delete;
+
+        // Id of the key, added on first use; kNoKeyId when the table is full
+        KeyId intern(std::string_view key);
+        KeyId intern(std::string_view key, uint64_t hash);
+
+        // Id of an already interned key, kNoKeyId otherwise (never blocks)
+        KeyId find(std::string_view key) const;
+        KeyId find(std::string_view key, uint64_t hash) const;
+
+        // Bytes of an interned key
+        std::string_view key(KeyId id) const;
+
+        inline size_t size() const { return size_.load(std::memory_order_acquire); }
+        inline size_t capacity() const { return max_keys_; }
+
+    private:
+        struct Entry {
+            uint64_t hash;
+            const char* data;
+            uint32_t length;
+            KeyId id;
+        };
+
+        const Entry* lookup(std::string_view key, uint64_t hash, size_t& slot) const;
+        const char* store(std::string_view key);
+
+        size_t max_keys_;
+        size_t mask_;
+        std::unique_ptr<std::atomic<const Entry*>[]> slots_;
+        std::unique_ptr<std::atomic<const Entry*>[]> by_id_;
+        std::atomic<size_t> size_{0};
+
+        // Owned by the inserting side, guarded by mutex_
+        std::mutex mutex_;
+        std::deque<Entry> entries_;
+        std::vector<char*> blocks_;
+        size_t block_used_ = 0;
+        size_t block_size_ = 0;
+    };
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_KEY_INTERNER_HPP
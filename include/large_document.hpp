@@ -0,0 +1,50 @@
+#ifndef LAZYJSON_LARGE_DOCUMENT_HPP
+#define LAZYJSON_LARGE_DOCUMENT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace lazyjson {
+
+    // Large-document mode. From this input size on, the tape (token vector and
+    // jump table) is not grown by doubling, which at several GB means copying
+    // tens of GB and briefly holding both copies: it is reserved once from an
+    // estimate of the token count. Should the estimate fall short, the tape is
+    // extended by the estimate of the input left (at least 1/8, see growTape):
+    // one more copy, but no doubled reservation. Reservations are marked for
+    // transparent huge pages before being touched, so that faulting the tape
+    // in costs one fault per 2 MB instead of one per 4 KB. Token values are
+    // views of 64 bit offsets and lengths and tapes of sources larger than
+    // 4 GB are written in the 64 bit sidecar layout (see sidecar.hpp).
+    constexpr size_t kLargeDocumentBytes = 64 * 1024 * 1024;
+
+    // Token count of `source` derived from its separators and brackets, counted
+    // in a few sampled windows (start, middle, end) and extrapolated, with margin
+    size_t estimateTokenCount(std::string_view source);
+
+    // Ask for transparent huge pages on [data, data + size) (no-op where the
+    // kernel does not support it). Only useful before the pages are first touched.
+    void adviseHugePages(const void* data, size_t size);
+
+    // Reserve room for `count` elements in one allocation, backed by huge pages
+    template<typename T>
+    void reserveTape(std::vector<T>& tape, size_t count) {
+        if (tape.capacity() >= count) {
+            return;
+        }
+        tape.reserve(count);
+        adviseHugePages(tape.data(), tape.capacity() * sizeof(T));
+    }
+
+    // Extend a full tape by `count` elements, and at least 1/8 of its size,
+    // instead of letting push_back double it
+    template<typename T>
+    void growTape(std::vector<T>& tape, size_t count) {
+        reserveTape(tape, tape.size() + std::max(count, tape.size() / 8));
+    }
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_LARGE_DOCUMENT_HPP
@@ -3,7 +3,12 @@
 
 #include "tokenizer.hpp"
 #include "data.hpp"
+#include "error.hpp"
 #include "string_buffer.hpp"
+#include "stats.hpp"
+#include "sidecar.hpp"
+#include "path.hpp"
+#include "shape.hpp"
 #include <memory>
 #include <string>
 #include <string_view>
@@ -13,47 +18,158 @@
 
 namespace lazyjson {
 
-    // JSON parser
+    class ValueView;
+
+    // JSON parser. Errors never throw nor print: the bool/int results come with
+    // lastError() (kind and byte offset), and find() returns them directly.
+    // Only allocation failures still throw (and terminate inside the noexcept find()).
     class Parser {
     public:
         Parser();
         
         // Parse a JSON string
-        bool parse(std::string& jsonString);
+        bool parse(std::string& jsonString) { return parse(std::string_view(jsonString)); }
+        // Same, for input owned elsewhere (it must outlive the parsed document)
+        bool parse(std::string_view jsonString);
+        // Tokens view the input: a temporary string would leave them dangling
+        bool parse(std::string&&) = delete;
+        // Literals and other C strings (would be ambiguous with the two above)
+        bool parse(const char* jsonString) { return parse(std::string_view(jsonString)); }
+
+        // Push mode: feed the document in chunks as they arrive (they are copied and
+        // tokenized immediately), then finish() completes the tape and parses it.
+        // The next feed() after finish() starts a new document.
+        bool feed(std::string_view chunk);
+        bool finish();
+
+        // Drop the parsed document but keep the allocated capacity (tokens, string
+        // buffer, root element) for the next parse; parse() and load() call it
+        void reset();
+
+        // Memory held by the parser between documents (see ParserPool)
+        size_t retainedBytes() const;
+
+        // Map a JSON file in memory and parse it, reusing its token tape sidecar when
+        // it matches the file (no tokenization at all) or creating it otherwise
+        bool load(const std::string& json_path, const std::string& tape_path,
+                  TapeValidation validation = TapeValidation::CONTENT_HASH);
+
+        // Persist the token tape of the parsed document (see sidecar.hpp)
+        bool saveTape(const std::string& tape_path) const;
         
+        // Why the last parse()/feed()/finish()/load()/get()/find() failed
+        inline const Error& lastError() const noexcept { return error_; }
+
+        // Value at a path expression, or why there is none (see error.hpp; the
+        // result is a ValueView, include value_view.hpp to use it). Only the
+        // containers on the way are materialized, as get() does; the value itself
+        // is viewed on the tape, and a missing key costs one hash lookup.
+        Expected<ValueView> find(std::string_view path) noexcept;
+        Expected<ValueView> find(const Path& path) noexcept;
+
         // Get/Set a value using a path expression
-        int get(const std::string&, std::shared_ptr<DataElement>&);
-        int set(const std::string&, std::shared_ptr<DataElement>);
+        int get(const std::string&, ElementPtr&);
+        // Same as above with a pre-split path (see path.hpp), no runtime path parsing.
+        // Paths resolved with the interner of the shape cache compare key ids.
+        int get(const Path&, ElementPtr&);
+        // Path resolved with the interner of the shape cache (unchanged without one)
+        Path resolvePath(const Path& path) const {
+            if (!shape_cache_ || !shape_cache_->interner()) return path;
+            return path.resolve(*shape_cache_->interner());
+        }
+        int set(const std::string&, ElementPtr);
         
         // Generate a JSON string from the parsed structure
         std::string dump() const;
-        std::string elementToString(std::shared_ptr<DataElement>) const;
+        std::string elementToString(ElementPtr) const;
+
+        // Token tape and root element of the parsed document, for tools walking
+        // the tape directly (exporters, ...)
+        inline const std::vector<Token>& getTokens() const { return tokens_; }
+        inline ElementPtr getRoot() const { return root_; }
+        // Matching bracket of every container token; empty after parse() (only
+        // load(), finish() and buildTokenJumps() build it)
+        inline const std::vector<size_t>& getTokenJumps() const { return token_jumps_; }
+        // Build the jump table for a document parsed with parse(), so that skipping
+        // a container is O(1); worth it for documents that are queried many times
+        void buildTokenJumps();
+        // Index of the last token of the value starting at `token_index` (the
+        // matching bracket of a container), using the jump table when present;
+        // `token_index` itself when the container is unbalanced
+        size_t valueEnd(size_t token_index) const;
+
+        // Object key layouts shared between documents (see shape.hpp). Off by
+        // default (one key map per object): interning costs a lock per object and
+        // only pays off when layouts repeat, across the documents of this parser
+        // or of every parser given the same cache.
+        inline void setShapeCache(std::shared_ptr<ShapeCache> cache) { shape_cache_ = std::move(cache); }
+        inline const std::shared_ptr<ShapeCache>& getShapeCache() const { return shape_cache_; }
+
+        // Counters and timings accumulated since construction (or the last resetStats()).
+        // Only populated when the library is built with LAZYJSON_ENABLE_STATS.
+        const ParserStats& stats() const { return stats_; }
+        void resetStats() { stats_.reset(); }
+        static bool statsEnabled();
 
     private:
 
+        // Parse the root element once tokens_ (and optionally token_jumps_) are ready
+        bool parseTokens();
+
         // Parse a JSON object/array (first level only)
-        int parseElement(std::shared_ptr<DataElement> element, size_t& currentIndex);
+        int parseElement(ElementPtr element, size_t& currentIndex);
 
-        //std::shared_ptr<DataElement> materializeToken(const std::vector<Token>& tokens, size_t& currentIndex);
+        //ElementPtr materializeToken(const std::vector<Token>& tokens, size_t& currentIndex);
         int materializeElement(DataElement&);
         
-        void dumpElement(const std::shared_ptr<lazyjson::DataElement>, std::ostringstream&, const auto&) const;
+        void dumpElement(const ElementPtr, std::ostringstream&, const auto&) const;
+
+        // Refresh the string buffer and memory usage counters
+        void updateMemoryStats() const;
 
-        // Parse a path expression
-        std::vector<std::string_view> splitPath(const std::string& path) const;
-        void skipValue(const std::vector<Token>& tokens, size_t& currentIndex);
+        // Record an error at the source offset of a token; returns 1
+        int fail(ErrorKind kind, size_t token_index) const;
+
+        int getComponents(const std::string_view* first, const std::string_view* last, const KeyId* ids,
+                          const KeyInterner* interner, ElementPtr&);
+        // Parse and materialize the child of `parent` starting at tokenIndex
+        ElementPtr materializeChild(DataElement& parent, std::string_view tokenKey, size_t tokenIndex);
+        // Replace `element` with its child `component` (by id when `interner` is set)
+        int getChild(ElementPtr& element, std::string_view component, KeyId id, const KeyInterner* interner);
+        int skipValue(const std::vector<Token>& tokens, size_t& currentIndex) const;
 
         // Tokenizer
         Tokenizer tokenizer_;
         
         // Tokens
         std::vector<Token> tokens_;
+
+        // Matching bracket of each container token, empty unless filled by load()
+        // (sidecar or fresh tokenization), finish() or buildTokenJumps(); lets
+        // skipValue and valueEnd jump over nested values
+        std::vector<size_t> token_jumps_;
+
+        // Input of feed()/finish(), tokens_ point into its buffer
+        StreamTokenizer stream_;
+
+        // Source mapped by load(), tokens_ point into it
+        std::shared_ptr<MappedFile> source_file_;
         
         // Root value
-        std::shared_ptr<DataElement> root_ = std::make_shared<DataElement>();
+        ElementPtr root_ = makeElement();
         
         // String buffer
         StringBuffer string_buffer_;
+
+        // Shape cache and the keys of the object being registered
+        std::shared_ptr<ShapeCache> shape_cache_;
+        std::vector<std::string_view> shape_keys_;
+
+        // Instrumentation (see stats.hpp)
+        mutable ParserStats stats_;
+
+        // Last failure, cleared by reset()
+        mutable Error error_;
     };
 
 } // namespace lazyjson
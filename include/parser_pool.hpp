@@ -0,0 +1,87 @@
+#ifndef LAZYJSON_PARSER_POOL_HPP
+#define LAZYJSON_PARSER_POOL_HPP
+
+#include "parser.hpp"
+#include <cstdint>
+#include <memory>
+
+namespace lazyjson {
+
+    // Recycles parsers between requests. Every thread keeps its own small cache of
+    // idle parsers (no locking on acquire/release); a parser comes back reset but
+    // with its token vector, string buffer and root element still allocated.
+    //
+    //     lazyjson::ParserPool pool;
+    //     {
+    //         auto parser = pool.acquire();
+    //         parser->parse(body);
+    //         ...
+    //     }   // returned to the cache of the releasing thread
+    //
+    // Idle parsers live until their thread exits (or until they do not fit the
+    // per-thread limits when released). Destroying the pool frees the idle
+    // parsers of the destroying thread; the other threads drop theirs on their
+    // next acquire() from any pool, and leases returned later are destroyed.
+    class ParserPool {
+    public:
+        struct Options {
+            // Idle parsers kept by each thread
+            size_t max_parsers_per_thread = 4;
+            // Memory (Parser::retainedBytes) idle parsers may hold in each thread
+            size_t max_retained_bytes_per_thread = 16 * 1024 * 1024;
+            // Shape cache given to every parser (nullptr: no shapes)
+            std::shared_ptr<ShapeCache> shape_cache;
+        };
+
+        // Shared with the leases, which may outlive the pool
+        struct State;
+
+        // Exclusive use of a parser until destruction
+        class Lease {
+        public:
+            Lease() = default;
+            Lease(Lease&&) noexcept = default;
+            Lease& operator=(Lease&& other) noexcept;
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+            ~Lease() { release(); }
+
+            inline Parser* get() const { return parser_.get(); }
+            inline Parser* operator->() const { return parser_.get(); }
+            inline Parser& operator*() const { return *parser_; }
+            inline explicit operator bool() const { return parser_ != nullptr; }
+
+            // Give the parser back before the end of the scope
+            void release();
+
+        private:
+            friend class ParserPool;
+            Lease(std::unique_ptr<Parser> parser, std::shared_ptr<const State> state)
+                : parser_(std::move(parser)), state_(std::move(state)) {}
+
+            std::unique_ptr<Parser> parser_;
+            std::shared_ptr<const State> state_;
+        };
+
+        ParserPool();
+        explicit ParserPool(Options options);
+        ~ParserPool();
+        ParserPool(const ParserPool&) = delete;
+        ParserPool& operator=(const ParserPool&) = delete;
+
+        Lease acquire();
+
+        // Idle parsers and their memory in the cache of the calling thread
+        size_t idleParsers() const;
+        size_t idleBytes() const;
+
+        // Parsers created because the thread cache was empty
+        uint64_t created() const;
+
+    private:
+        std::shared_ptr<State> state_;
+    };
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_PARSER_POOL_HPP
@@ -0,0 +1,125 @@
+#ifndef LAZYJSON_PATH_HPP
+#define LAZYJSON_PATH_HPP
+
+#include "hash.hpp"
+#include "key_interner.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace lazyjson {
+
+    // Pre-split path expression (same syntax as Parser::get: "a.b[3].c").
+    // "[*]" stands for every element of an array; it is only understood by the
+    // tape aggregations of reduce.hpp (Parser::get never matches it).
+    // The constructor is constexpr: with a literal the path is split, validated and
+    // its keys hashed at compile time, and an invalid path is a compile error
+    //
+    //     using namespace lazyjson::literals;
+    //     constexpr auto price = "order.items[3].price"_jpath;
+    //     parser.get(price, element);
+    //
+    // A Path only holds views: when it is built at runtime the string must
+    // outlive it. resolve() additionally maps the object keys to the ids of a
+    // KeyInterner, once, so lookups in shaped objects become integer compares.
+    class Path {
+    public:
+        static constexpr size_t kMaxComponents = 16;
+        static constexpr size_t kNoIndex = static_cast<size_t>(-1);
+        static constexpr size_t kWildcard = static_cast<size_t>(-2);
+
+        constexpr Path() = default;
+
+        constexpr explicit Path(std::string_view path) {
+            size_t start = 0;
+            size_t pos = 0;
+            while (pos < path.size()) {
+                if (path[pos] == '.') {
+                    if (pos > start) push(path.substr(start, pos - start), false);
+                    start = pos + 1;
+                } else if (path[pos] == '[') {
+                    if (pos > start) push(path.substr(start, pos - start), false);
+                    size_t close = path.find(']', pos);
+                    if (close == std::string_view::npos) {
+                        throw std::runtime_error("Unterminated '[' in path");
+                    }
+                    push(path.substr(pos + 1, close - pos - 1), true);
+                    pos = close;
+                    start = pos + 1;
+                }
+                pos++;
+            }
+            if (pos > start) push(path.substr(start, pos - start), false);
+        }
+
+        constexpr size_t size() const { return size_; }
+        constexpr bool empty() const { return size_ == 0; }
+
+        // Component text, as registered in objects (keys) and arrays (decimal index)
+        constexpr std::string_view key(size_t i) const { return keys_[i]; }
+        constexpr uint64_t hash(size_t i) const { return hashes_[i]; }
+        // Array index of a bracket component, kNoIndex for object keys
+        constexpr size_t index(size_t i) const { return indices_[i]; }
+        constexpr bool isWildcard(size_t i) const { return indices_[i] == kWildcard; }
+
+        // Interned id of an object key, kNoKeyId unless resolved
+        constexpr KeyId id(size_t i) const { return ids_[i]; }
+        constexpr const KeyId* ids() const { return ids_; }
+        constexpr const KeyInterner* interner() const { return interner_; }
+
+        // Copy of the path with the object keys interned (see ShapeCache)
+        Path resolve(KeyInterner& interner) const {
+            Path resolved = *this;
+            resolved.interner_ = &interner;
+            for (size_t i = 0; i < size_; i++) {
+                resolved.ids_[i] = indices_[i] == kNoIndex ? interner.intern(keys_[i], hashes_[i]) : kNoKeyId;
+            }
+            return resolved;
+        }
+
+        constexpr const std::string_view* begin() const { return keys_; }
+        constexpr const std::string_view* end() const { return keys_ + size_; }
+
+    private:
+        constexpr void push(std::string_view key, bool bracket) {
+            if (size_ == kMaxComponents) {
+                throw std::runtime_error("Too many components in path");
+            }
+            size_t index = kNoIndex;
+            if (bracket) {
+                if (key.empty()) throw std::runtime_error("Empty index in path");
+                if (key == "*") {
+                    index = kWildcard;
+                } else {
+                    index = 0;
+                    for (char c : key) {
+                        if (c < '0' || c > '9') throw std::runtime_error("Invalid index in path");
+                        index = index * 10 + static_cast<size_t>(c - '0');
+                    }
+                }
+            }
+            keys_[size_] = key;
+            hashes_[size_] = hashKey(key);
+            indices_[size_] = index;
+            ids_[size_] = kNoKeyId;
+            size_++;
+        }
+
+        std::string_view keys_[kMaxComponents] = {};
+        uint64_t hashes_[kMaxComponents] = {};
+        size_t indices_[kMaxComponents] = {};
+        KeyId ids_[kMaxComponents] = {};
+        const KeyInterner* interner_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    namespace literals {
+        constexpr Path operator""_jpath(const char* path, size_t length) {
+            return Path(std::string_view(path, length));
+        }
+    }
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_PATH_HPP
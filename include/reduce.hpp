@@ -0,0 +1,130 @@
+#ifndef LAZYJSON_REDUCE_HPP
+#define LAZYJSON_REDUCE_HPP
+
+#include "parser.hpp"
+#include "path.hpp"
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <string_view>
+
+namespace lazyjson {
+
+    // Numeric aggregations computed straight from the token tape.
+    // The path selects the numbers to aggregate; "[*]" expands every element of
+    // an array, at any depth:
+    //
+    //     double total = lazyjson::reduce(parser, "metrics.values[*]", lazyjson::Sum{});
+    //     double worst = lazyjson::reduce(parser, "requests[*].latency", lazyjson::Max{});
+    //
+    // No DataElement is created: matching TOKEN_NUMBER spans are converted in
+    // batches into a contiguous buffer (integers without a call into the C
+    // library) and handed to the reducer. Non numeric values are skipped.
+    // A path that does not exist throws std::runtime_error; below a wildcard,
+    // elements lacking the rest of the path are skipped instead.
+    //
+    // A reducer is any type with add(const double* values, size_t count) and
+    // result(); the ones below keep independent accumulators so the loops
+    // pipeline (and vectorize where the compiler allows).
+
+    struct Sum {
+        double lanes[4] = {0, 0, 0, 0};
+
+        inline void add(const double* values, size_t count) {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                lanes[0] += values[i];
+                lanes[1] += values[i + 1];
+                lanes[2] += values[i + 2];
+                lanes[3] += values[i + 3];
+            }
+            for (; i < count; i++) lanes[0] += values[i];
+        }
+        inline double result() const { return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]); }
+    };
+
+    struct Min {
+        double lanes[4] = {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+                           std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+
+        inline void add(const double* values, size_t count) {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                for (size_t lane = 0; lane < 4; lane++) {
+                    lanes[lane] = values[i + lane] < lanes[lane] ? values[i + lane] : lanes[lane];
+                }
+            }
+            for (; i < count; i++) lanes[0] = values[i] < lanes[0] ? values[i] : lanes[0];
+        }
+        // +infinity when nothing matched
+        inline double result() const {
+            const double a = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+            const double b = lanes[2] < lanes[3] ? lanes[2] : lanes[3];
+            return a < b ? a : b;
+        }
+    };
+
+    struct Max {
+        double lanes[4] = {-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+                           -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+
+        inline void add(const double* values, size_t count) {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                for (size_t lane = 0; lane < 4; lane++) {
+                    lanes[lane] = values[i + lane] > lanes[lane] ? values[i + lane] : lanes[lane];
+                }
+            }
+            for (; i < count; i++) lanes[0] = values[i] > lanes[0] ? values[i] : lanes[0];
+        }
+        // -infinity when nothing matched
+        inline double result() const {
+            const double a = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+            const double b = lanes[2] > lanes[3] ? lanes[2] : lanes[3];
+            return a > b ? a : b;
+        }
+    };
+
+    // Number of numeric values
+    struct Count {
+        size_t value = 0;
+
+        inline void add(const double*, size_t count) { value += count; }
+        inline size_t result() const { return value; }
+    };
+
+    // Arithmetic mean, NaN when nothing matched
+    struct Mean {
+        Sum sum;
+        size_t count = 0;
+
+        inline void add(const double* values, size_t n) {
+            sum.add(values, n);
+            count += n;
+        }
+        inline double result() const {
+            return count ? sum.result() / static_cast<double>(count) : std::numeric_limits<double>::quiet_NaN();
+        }
+    };
+
+    namespace reduce_detail {
+        // Calls fn(values, count) with consecutive batches of the numbers selected by `path`
+        void scanNumbers(const Parser& parser, const Path& path, const std::function<void(const double*, size_t)>& fn);
+    }
+
+    template<typename Reducer>
+    auto reduce(const Parser& parser, const Path& path, Reducer reducer) {
+        reduce_detail::scanNumbers(parser, path, [&reducer](const double* values, size_t count) {
+            reducer.add(values, count);
+        });
+        return reducer.result();
+    }
+
+    template<typename Reducer>
+    auto reduce(const Parser& parser, std::string_view path, Reducer reducer) {
+        return reduce(parser, Path(path), std::move(reducer));
+    }
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_REDUCE_HPP
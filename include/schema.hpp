@@ -0,0 +1,127 @@
+#ifndef LAZYJSON_SCHEMA_HPP
+#define LAZYJSON_SCHEMA_HPP
+
+#include "parser.hpp"
+#include "tokenizer.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lazyjson {
+
+    enum class SchemaError {
+        NONE,
+        INVALID_SCHEMA,       // compile(): unsupported or malformed schema
+        MALFORMED_DOCUMENT,   // the document itself is not valid JSON
+        TYPE_MISMATCH,
+        MISSING_REQUIRED,
+        ADDITIONAL_PROPERTY,
+        ENUM_MISMATCH,
+        OUT_OF_RANGE,         // minimum / maximum / exclusiveMinimum / exclusiveMaximum
+        LENGTH_OUT_OF_RANGE,  // minLength / maxLength
+        ITEMS_OUT_OF_RANGE,   // minItems / maxItems
+        PROPERTIES_OUT_OF_RANGE,  // minProperties / maxProperties
+        NOT_MULTIPLE_OF
+    };
+    std::ostream& operator<<(std::ostream& os, const SchemaError& error);
+
+    struct ValidationError {
+        SchemaError error = SchemaError::NONE;
+        std::string path;     // JSON pointer of the offending value
+        std::string message;
+    };
+
+    // JSON Schema subset compiled to a node table and checked on a token tape.
+    // Supported keywords: type (including "integer" and arrays of types),
+    // properties, required, additionalProperties (boolean), minProperties,
+    // maxProperties, items (single schema), minItems, maxItems, enum and const
+    // (scalar values), minimum, maximum, exclusiveMinimum, exclusiveMaximum,
+    // multipleOf, minLength, maxLength, and the boolean schemas true / false.
+    // Annotations ($schema, title, description, ...) are ignored; keywords
+    // changing the meaning of a schema that are not supported ($ref, allOf,
+    // anyOf, oneOf, not, pattern, ...) make compile() fail rather than pass
+    // silently.
+    //
+    // Validation walks the tape once, stops at the first error and allocates
+    // nothing on success: no DataElement is created, numbers are only converted
+    // when a range or "integer" applies and strings are only decoded when they
+    // contain escapes. A compiled Schema is immutable and can be shared by threads.
+    //
+    //     lazyjson::Schema schema;
+    //     std::string message;
+    //     if (schema.compile(schema_text, message) != 0) ...
+    //     lazyjson::ValidationError error;
+    //     if (!schema.validate(payload, error)) std::cerr << error.path << ": " << error.message;
+    class Schema {
+    public:
+        // Compile a schema document; 0 on success, 1 with a message otherwise
+        int compile(std::string_view schema, std::string& message);
+
+        // Validate a token tape as produced by Tokenizer::tokenize (or a Parser)
+        bool validate(const std::vector<Token>& tokens, ValidationError& error) const;
+        // Tokenize and validate (thread local tokenizer, no allocation once warm)
+        bool validate(std::string_view json, ValidationError& error) const;
+        bool validate(const Parser& parser, ValidationError& error) const;
+
+        inline bool empty() const { return nodes_.empty(); }
+
+    private:
+        class Compiler;
+        class Validator;
+
+        static constexpr uint32_t kNone = UINT32_MAX;
+
+        // Bits of Node::types
+        enum : uint8_t {
+            TYPE_NULL = 1,
+            TYPE_BOOLEAN = 2,
+            TYPE_INTEGER = 4,
+            TYPE_NUMBER = 8,
+            TYPE_STRING = 16,
+            TYPE_ARRAY = 32,
+            TYPE_OBJECT = 64,
+            TYPE_ANY = 127
+        };
+
+        // Scalar of an enum/const (strings decoded)
+        struct EnumValue {
+            TokenType type;
+            double number;
+            std::string text;
+        };
+
+        struct Property {
+            std::string key;
+            uint32_t node;        // kNone: any value
+            int32_t required_bit; // -1 when not required
+        };
+
+        struct Node {
+            uint8_t types = TYPE_ANY;
+            bool additional_properties = true;
+            // Inclusive and exclusive bounds are independent (both may be set)
+            bool has_minimum = false, has_maximum = false;
+            bool has_exclusive_minimum = false, has_exclusive_maximum = false;
+            double minimum = 0, maximum = 0;
+            double exclusive_minimum = 0, exclusive_maximum = 0;
+            size_t min_length = 0, max_length = SIZE_MAX;
+            size_t min_items = 0, max_items = SIZE_MAX;
+            size_t min_properties = 0, max_properties = SIZE_MAX;
+            double multiple_of = 0;  // 0: none
+            uint32_t items = kNone;
+            // Ranges in properties_ (sorted by key) and enums_
+            uint32_t properties_begin = 0, properties_end = 0;
+            uint32_t enums_begin = 0, enums_end = 0;
+            uint64_t required_mask = 0;
+        };
+
+        std::vector<Node> nodes_;  // nodes_[0] is the root
+        std::vector<Property> properties_;
+        std::vector<EnumValue> enums_;
+    };
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_SCHEMA_HPP
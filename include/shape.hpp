@@ -0,0 +1,113 @@
+#ifndef LAZYJSON_SHAPE_HPP
+#define LAZYJSON_SHAPE_HPP
+
+#include "key_interner.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lazyjson {
+
+    // Ordered key sequence shared by every object with the same layout (a "hidden
+    // class"). An object using a shape only stores the token index of each slot;
+    // the key -> slot map is built once per shape instead of once per object.
+    class Shape {
+    public:
+        static constexpr size_t kNoSlot = static_cast<size_t>(-1);
+
+        // Keys are copied into the shape; with an interner each slot also gets the key id
+        Shape(const std::vector<std::string_view>& keys, uint64_t hash, KeyInterner* interner = nullptr);
+
+        Shape(const Shape&) = delete;
+        Shape& operator=(const Shape&) = delete;
+
+        inline size_t size() const { return keys_.size(); }
+        inline uint64_t hash() const { return hash_; }
+        inline const std::vector<std::string_view>& keys() const { return keys_; }
+        inline std::string_view key(size_t slot) const { return keys_[slot]; }
+
+        inline size_t slot(std::string_view key) const {
+            auto it = slots_.find(key);
+            return it == slots_.end() ? kNoSlot : it->second;
+        }
+
+        // Slot of an interned key (integer compares only), kNoSlot when absent or
+        // when the shape was not built with that interner
+        inline size_t slotById(const KeyInterner* interner, KeyId id) const {
+            if (interner != interner_ || id == kNoKeyId) return kNoSlot;
+            for (size_t slot = 0; slot < ids_.size(); slot++) {
+                if (ids_[slot] == id) return slot;
+            }
+            return kNoSlot;
+        }
+        inline const KeyInterner* interner() const { return interner_; }
+
+        // False when a key appears more than once (such a shape is never cached)
+        inline bool unique() const { return slots_.size() == keys_.size(); }
+
+        // Same keys in the same order
+        bool matches(const std::vector<std::string_view>& keys) const;
+
+    private:
+        std::string storage_;
+        std::vector<std::string_view> keys_;
+        std::unordered_map<std::string_view, size_t> slots_;
+        uint64_t hash_;
+        const KeyInterner* interner_ = nullptr;
+        std::vector<KeyId> ids_;
+    };
+
+    // Bounded set of shapes, safe to share between parsers running on different
+    // threads (lookups take a shared lock, new shapes an exclusive one).
+    // Once full, new layouts are not cached and the objects using them fall
+    // back to a per-object key map.
+    class ShapeCache {
+    public:
+        // With an interner, shaped keys get ids and can be found by Path::resolve()d paths
+        explicit ShapeCache(size_t max_shapes = 1024, size_t max_keys = 64,
+                            std::shared_ptr<KeyInterner> interner = nullptr)
+            : max_shapes_(max_shapes), max_keys_(max_keys), interner_(std::move(interner)) {}
+
+        ShapeCache(const ShapeCache&) = delete;
+        ShapeCache& operator=(const ShapeCache&) = delete;
+
+        // Incremental hash of an ordered key sequence
+        static uint64_t hashKeys(const std::vector<std::string_view>& keys);
+
+        // Shape for the key sequence (with its hashKeys() value), created on first
+        // use; nullptr when the sequence cannot be shaped (duplicate keys, too many
+        // keys, cache full)
+        std::shared_ptr<const Shape> intern(const std::vector<std::string_view>& keys, uint64_t hash);
+
+        size_t size() const;
+        void clear();
+
+        inline size_t maxKeys() const { return max_keys_; }
+        inline const std::shared_ptr<KeyInterner>& interner() const { return interner_; }
+        inline uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+        inline uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+    private:
+        using ShapeMap = std::unordered_multimap<uint64_t, std::shared_ptr<const Shape>>;
+        static std::shared_ptr<const Shape> find(const ShapeMap& shapes, const std::vector<std::string_view>& keys, uint64_t hash);
+        static bool distinctKeys(const std::vector<std::string_view>& keys);
+
+        size_t max_shapes_;
+        size_t max_keys_;
+        std::shared_ptr<KeyInterner> interner_;
+        mutable std::shared_mutex mutex_;
+        ShapeMap shapes_;
+        // Layouts with duplicate keys (bounded like shapes_), refused without rebuilding them
+        ShapeMap rejected_;
+        std::atomic<uint64_t> hits_{0};
+        std::atomic<uint64_t> misses_{0};
+    };
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_SHAPE_HPP
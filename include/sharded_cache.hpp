@@ -0,0 +1,270 @@
+#ifndef LAZYJSON_SHARDED_CACHE_HPP
+#define LAZYJSON_SHARDED_CACHE_HPP
+
+#include "hash.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lazyjson {
+
+    struct CacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+        // Insertions refused because the entry alone exceeds a shard
+        uint64_t rejections = 0;
+        size_t entries = 0;
+        size_t charge = 0;
+
+        inline double hitRatio() const {
+            return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+        }
+    };
+
+    inline std::ostream& operator<<(std::ostream& os, const CacheStats& stats) {
+        os << "{\"hits\":" << stats.hits
+           << ",\"misses\":" << stats.misses
+           << ",\"insertions\":" << stats.insertions
+           << ",\"evictions\":" << stats.evictions
+           << ",\"rejections\":" << stats.rejections
+           << ",\"entries\":" << stats.entries
+           << ",\"charge\":" << stats.charge
+           << "}";
+        return os;
+    }
+
+    // Thread safe cache from string keys to `Value`, bounded in bytes.
+    //
+    // The key space is split into shards (a power of 2) by the high bits of the
+    // key hash, each with its own mutex, so threads touching different keys
+    // rarely meet on the same lock. Within a shard eviction is CLOCK: a hit only
+    // sets the entry's reference bit, and the hand sweeping the slots gives a
+    // referenced entry a second chance and evicts the first unreferenced one.
+    // Unlike strict LRU a hit does not reorder anything, which keeps the
+    // critical section of a lookup down to a hash probe and a flag store.
+    //
+    // Every entry is charged its key, its bookkeeping and the `charge` given at
+    // insertion (the memory owned by the value); each shard holds at most
+    // capacity / shards bytes. Lookups take the key as a string_view and never
+    // allocate; the overloads taking a hash first reuse one computed by the
+    // caller with hash(), e.g. once per request for several caches.
+    //
+    // Values are copied out under the shard lock: use a type whose copies may
+    // be handed to other threads (std::shared_ptr, plain values). ElementPtr is
+    // only suitable in the shared and intrusive_atomic builds.
+    template<typename Value>
+    class ShardedCache {
+    public:
+        // shards == 0: about 4 per hardware thread
+        explicit ShardedCache(size_t capacity_bytes, size_t shards = 0) : capacity_(capacity_bytes) {
+            if (capacity_bytes == 0) {
+                throw std::invalid_argument("Cache capacity must be greater than 0");
+            }
+            if (shards == 0) {
+                shards = 4 * std::max(1u, std::thread::hardware_concurrency());
+            }
+            size_t count = 1;
+            while (count < shards && count < 1024) count <<= 1;
+            shards_ = std::make_unique<Shard[]>(count);
+            shard_mask_ = count - 1;
+            for (size_t i = 0; i < count; i++) {
+                shards_[i].capacity = capacity_bytes / count + (i < capacity_bytes % count ? 1 : 0);
+            }
+        }
+
+        ShardedCache(const ShardedCache&) = delete;
+        ShardedCache& operator=(const ShardedCache&) = delete;
+
+        static inline uint64_t hash(std::string_view key) { return hashBytes(key); }
+
+        // Copy the value cached for `key` into `out`
+        inline bool lookup(std::string_view key, Value& out) { return lookup(hash(key), key, out); }
+        bool lookup(uint64_t key_hash, std::string_view key, Value& out) {
+            Shard& shard = shardFor(key_hash);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key_hash);
+            if (it == shard.index.end() || shard.slots[it->second].key != key) {
+                shard.misses++;
+                return false;
+            }
+            Slot& slot = shard.slots[it->second];
+            slot.referenced = true;
+            out = slot.value;
+            shard.hits++;
+            return true;
+        }
+
+        // Insert or replace; false when the entry does not fit in a shard at all
+        inline bool insert(std::string_view key, Value value, size_t charge = 0) {
+            return insert(hash(key), key, std::move(value), charge);
+        }
+        bool insert(uint64_t key_hash, std::string_view key, Value value, size_t charge = 0) {
+            Shard& shard = shardFor(key_hash);
+            const size_t total = charge + key.size() + kEntryOverhead;
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (total > shard.capacity) {
+                shard.rejections++;
+                return false;
+            }
+            // Same hash: replaced in place, whether it is the same key or a (rare) collision
+            auto it = shard.index.find(key_hash);
+            if (it != shard.index.end()) {
+                release(shard, it->second);
+                shard.index.erase(it);
+            }
+            while (shard.charge + total > shard.capacity) {
+                evictOne(shard);
+            }
+            uint32_t position;
+            if (!shard.free.empty()) {
+                position = shard.free.back();
+                shard.free.pop_back();
+            } else {
+                position = static_cast<uint32_t>(shard.slots.size());
+                shard.slots.emplace_back();
+            }
+            Slot& slot = shard.slots[position];
+            slot.key.assign(key.data(), key.size());
+            slot.hash = key_hash;
+            slot.value = std::move(value);
+            slot.charge = total;
+            slot.used = true;
+            // A new entry has to survive one sweep on its own before it earns a second chance
+            slot.referenced = false;
+            shard.index.emplace(key_hash, position);
+            shard.charge += total;
+            shard.insertions++;
+            return true;
+        }
+
+        inline bool erase(std::string_view key) { return erase(hash(key), key); }
+        bool erase(uint64_t key_hash, std::string_view key) {
+            Shard& shard = shardFor(key_hash);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key_hash);
+            if (it == shard.index.end() || shard.slots[it->second].key != key) {
+                return false;
+            }
+            release(shard, it->second);
+            shard.index.erase(it);
+            return true;
+        }
+
+        void clear() {
+            for (size_t i = 0; i <= shard_mask_; i++) {
+                Shard& shard = shards_[i];
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.slots.clear();
+                shard.free.clear();
+                shard.index.clear();
+                shard.charge = 0;
+                shard.hand = 0;
+            }
+        }
+
+        inline size_t capacity() const { return capacity_; }
+        inline size_t shardCount() const { return shard_mask_ + 1; }
+
+        // Counters summed over the shards (each shard is read under its lock)
+        CacheStats stats() const {
+            CacheStats stats;
+            for (size_t i = 0; i <= shard_mask_; i++) {
+                Shard& shard = shards_[i];
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                stats.hits += shard.hits;
+                stats.misses += shard.misses;
+                stats.insertions += shard.insertions;
+                stats.evictions += shard.evictions;
+                stats.rejections += shard.rejections;
+                stats.entries += shard.index.size();
+                stats.charge += shard.charge;
+            }
+            return stats;
+        }
+
+        inline size_t size() const { return stats().entries; }
+        inline size_t charge() const { return stats().charge; }
+
+        // Bytes charged to every entry besides its key and its own charge
+        static constexpr size_t kEntryOverhead = 64 + sizeof(Value);
+
+    private:
+        struct Slot {
+            std::string key;
+            uint64_t hash = 0;
+            Value value{};
+            size_t charge = 0;
+            bool used = false;
+            bool referenced = false;
+        };
+
+        // Aligned to keep the locks of neighbouring shards off the same cache line
+        struct alignas(64) Shard {
+            std::mutex mutex;
+            std::vector<Slot> slots;
+            std::vector<uint32_t> free;
+            std::unordered_map<uint64_t, uint32_t> index;
+            size_t capacity = 0;
+            size_t charge = 0;
+            size_t hand = 0;
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t insertions = 0;
+            uint64_t evictions = 0;
+            uint64_t rejections = 0;
+        };
+
+        inline Shard& shardFor(uint64_t key_hash) const {
+            // High bits: the low ones already pick the bucket of the shard's map
+            return shards_[(key_hash >> 40) & shard_mask_];
+        }
+
+        // Empties a slot (its index entry is removed by the caller)
+        static void release(Shard& shard, uint32_t position) {
+            Slot& slot = shard.slots[position];
+            shard.charge -= slot.charge;
+            slot.used = false;
+            slot.value = Value{};
+            slot.key.clear();
+            shard.free.push_back(position);
+        }
+
+        // Advances the CLOCK hand to the first unreferenced entry and evicts it.
+        // Called with a non empty shard, so at most two sweeps are needed.
+        static void evictOne(Shard& shard) {
+            for (;;) {
+                if (shard.hand >= shard.slots.size()) shard.hand = 0;
+                Slot& slot = shard.slots[shard.hand];
+                const uint32_t position = static_cast<uint32_t>(shard.hand++);
+                if (!slot.used) continue;
+                if (slot.referenced) {
+                    slot.referenced = false;
+                    continue;
+                }
+                shard.index.erase(slot.hash);
+                release(shard, position);
+                shard.evictions++;
+                return;
+            }
+        }
+
+        size_t capacity_;
+        size_t shard_mask_ = 0;
+        std::unique_ptr<Shard[]> shards_;
+    };
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_SHARDED_CACHE_HPP
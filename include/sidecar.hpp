@@ -0,0 +1,89 @@
+#ifndef LAZYJSON_SIDECAR_HPP
+#define LAZYJSON_SIDECAR_HPP
+
+#include "tokenizer.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lazyjson {
+
+    // Token tape sidecar: the output of Tokenizer::tokenize persisted next to a
+    // large JSON file, so that later runs can skip tokenization entirely.
+    //
+    // Layout (host byte order, every section 8 byte aligned):
+    //   TapeHeader
+    //   uint32_t offset[token_count]   token value start, relative to the source
+    //   uint32_t length[token_count]   token value length
+    //   uint32_t jump[token_count]     matching bracket for '{' '}' '[' ']', own index otherwise
+    //   uint8_t  type[token_count]     TokenType
+    // Version 2, written only when the source or the token count exceed 4 GB
+    // (version 1 stays the smaller layout for everything else), widens offset
+    // and jump to uint64_t; lengths stay 32 bit.
+    struct TapeHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t flags;
+        uint64_t source_size;
+        uint64_t source_hash;       // hashBytes() of the whole source
+        uint64_t token_count;
+    };
+
+    enum class TapeError {
+        NONE,
+        IO_ERROR,
+        INVALID_FORMAT,
+        SOURCE_MISMATCH,
+        SOURCE_TOO_LARGE,
+    };
+    std::ostream& operator<<(std::ostream& os, const TapeError& error);
+
+    // How a sidecar is checked against its source before being trusted
+    enum class TapeValidation {
+        CONTENT_HASH,   // Hash the whole source (safe, costs one pass over the bytes)
+        SIZE_ONLY       // Only compare the size (instant, the caller guarantees the file is unchanged)
+    };
+
+    // Read only memory mapping of a whole file
+    class MappedFile {
+    public:
+        MappedFile() {}
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        int open(const std::string& path, TapeError& error);
+        void close();
+
+        inline const char* data() const { return data_; }
+        inline size_t size() const { return size_; }
+        inline std::string_view view() const { return {data_, size_}; }
+
+        // Hint that the file is read front to back (more read-ahead)
+        void adviseSequential() const;
+        // Drop the resident pages before `offset`; they are read again if accessed
+        void discard(size_t offset) const;
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    // Index of the matching bracket of every container token (own index for the others)
+    void computeJumps(const std::vector<Token>& tokens, std::vector<size_t>& jumps);
+
+    // Persist the tokens of `source` (as produced by Tokenizer::tokenize on it)
+    int writeTape(const std::string& tape_path, std::string_view source,
+                  const std::vector<Token>& tokens, const std::vector<size_t>& jumps, TapeError& error);
+
+    // Rebuild tokens and jumps for `source` from a sidecar, without tokenizing.
+    // INVALID_FORMAT as well for views outside the source or jumps that do not pair
+    // brackets, which only a corrupted (or unbalanced) tape contains.
+    int readTape(const std::string& tape_path, std::string_view source, TapeValidation validation,
+                 std::vector<Token>& tokens, std::vector<size_t>& jumps, TapeError& error);
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_SIDECAR_HPP
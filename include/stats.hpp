@@ -0,0 +1,85 @@
+#ifndef LAZYJSON_STATS_HPP
+#define LAZYJSON_STATS_HPP
+
+#include "tokenizer.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace lazyjson {
+
+    constexpr size_t kTokenTypeCount = static_cast<size_t>(TokenType::TOKEN_ERROR) + 1;
+
+    // Counters and timings collected by a Parser.
+    // The structure is always part of the Parser (so the layout does not depend
+    // on build flags), but it is only updated when the library is compiled with
+    // LAZYJSON_ENABLE_STATS; otherwise every field stays at zero and the hot
+    // paths carry no instrumentation at all.
+    struct ParserStats {
+        // Tokens produced by the tokenizer, indexed by TokenType
+        std::array<uint64_t, kTokenTypeCount> tokens_by_type{};
+        uint64_t bytes_scanned = 0;
+
+        // Wall clock time spent in each phase
+        uint64_t tokenize_ns = 0;       // Tokenizer::tokenize
+        uint64_t parse_ns = 0;          // Parser::parse, tokenization excluded
+        uint64_t materialize_ns = 0;    // Children materialized on demand by get()
+        uint64_t dump_ns = 0;           // dump() and elementToString()
+
+        // Children registered (key -> token index) versus DataElement actually created
+        uint64_t nodes_registered = 0;
+        uint64_t nodes_materialized = 0;
+
+        // StringBuffer usage at the end of the last parse/get
+        uint64_t string_buffer_bytes = 0;
+        uint64_t string_buffer_capacity = 0;
+        uint64_t string_buffer_blocks = 0;
+        uint64_t string_buffer_wasted = 0;     // Alignment padding and abandoned block tails
+
+        // Objects registered through a cached shape (see shape.hpp)
+        uint64_t shaped_objects = 0;
+
+        // Path components resolved from an already materialized child (hit)
+        // or by parsing the token tape (miss)
+        uint64_t path_cache_hits = 0;
+        uint64_t path_cache_misses = 0;
+
+        // Estimate of the memory held by the parser (tokens, string buffer, nodes)
+        uint64_t memory_bytes = 0;
+        uint64_t peak_memory_bytes = 0;
+
+        uint64_t tokenCount(TokenType type) const { return tokens_by_type[static_cast<size_t>(type)]; }
+        void reset() { *this = ParserStats{}; }
+    };
+
+    // Writes the statistics as a single JSON object
+    std::ostream& operator<<(std::ostream& os, const ParserStats& stats);
+
+    // Adds the time spent in the enclosing scope to a counter
+    class StatsTimer {
+        public:
+            explicit StatsTimer(uint64_t& target) : target_(target), start_(std::chrono::steady_clock::now()) {}
+            ~StatsTimer() {
+                target_ += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start_).count());
+            }
+            StatsTimer(const StatsTimer&) = delete;
+            StatsTimer& operator=(const StatsTimer&) = delete;
+
+        private:
+            uint64_t& target_;
+            std::chrono::steady_clock::time_point start_;
+    };
+
+} // namespace lazyjson
+
+#ifdef LAZYJSON_ENABLE_STATS
+    #define LAZYJSON_STATS(...) do { __VA_ARGS__; } while (0)
+    #define LAZYJSON_STATS_TIMER(name, target) ::lazyjson::StatsTimer name(target)
+#else
+    #define LAZYJSON_STATS(...) do {} while (0)
+    #define LAZYJSON_STATS_TIMER(name, target) do {} while (0)
+#endif
+
+#endif // LAZYJSON_STATS_HPP
@@ -1,161 +1,125 @@
 #ifndef LAZYJSON_STRING_BUFFER_HPP
 #define LAZYJSON_STRING_BUFFER_HPP
 
-#include <string>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 #include <string_view>
 #include <vector>
-#include <cstring>
-#include <stdexcept>
 
 namespace lazyjson {
 
+// Arena a puntatore mobile (bump pointer): le allocazioni avanzano un puntatore
+// nel blocco corrente e quando non c'e' spazio si passa a un blocco nuovo,
+// grande il doppio del precedente (fino a kMaxBlockSize). Le viste e i puntatori
+// restituiti restano validi fino a clear(), che e' O(1) sul contenuto: non
+// azzera la memoria e conserva solo il blocco piu' grande.
 class StringBuffer {
-private:
-    struct Block {
-        char* data;
-        size_t capacity;
-        size_t used;
-        
-        Block(size_t size) : capacity(size), used(0) {
-            data = static_cast<char*>(std::malloc(size));
-            if (!data) {
-                throw std::bad_alloc();
-            }
-        }
-        
-        ~Block() {
-            if (data) {
-                std::free(data);
-                data = nullptr;
-            }
-        }
-        
-        // Impedisci la copia
-        Block(const Block&) = delete;
-        Block& operator=(const Block&) = delete;
-        
-        // Permetti il movimento
-        Block(Block&& other) noexcept : data(other.data), capacity(other.capacity), used(other.used) {
-            other.data = nullptr;
-            other.capacity = 0;
-            other.used = 0;
-        }
-        
-        Block& operator=(Block&& other) noexcept {
-            if (this != &other) {
-                if (data) {
-                    std::free(data);
-                }
-                data = other.data;
-                capacity = other.capacity;
-                used = other.used;
-                
-                other.data = nullptr;
-                other.capacity = 0;
-                other.used = 0;
-            }
-            return *this;
-        }
-        
-        bool can_fit(size_t size) const {
-            return used + size <= capacity;
-        }
-        
-        std::string_view add_string(const std::string& value) {
-            size_t size = value.size();
-            if (!can_fit(size)) {
-                return std::string_view(); // Empty view to indicate failure
-            }
-            
-            std::memcpy(data + used, value.data(), size);
-            std::string_view result(data + used, size);
-            used += size;
-            return result;
-        }
-        
-        void clear() {
-            if (data && used > 0) {
-                std::memset(data, 0, used);
-                used = 0;
-            }
-        }
-    };
-    
-    // Vettore di blocchi di memoria
-    std::vector<Block> blocks;
-    
-    // Dimensione fissa per i blocchi
-    size_t block_size;
-    
 public:
-    // Costruttore con dimensione del blocco (obbligatoria)
-    explicit StringBuffer(size_t block_size) : block_size(block_size) {
-        // Crea il primo blocco con la dimensione specificata
-        blocks.emplace_back(block_size);
+    // Oltre questa dimensione i blocchi smettono di raddoppiare
+    static constexpr size_t kMaxBlockSize = 16 * 1024 * 1024;
+
+    explicit StringBuffer(size_t block_size) : next_block_size_(block_size ? block_size : 64) {
+        addBlock(next_block_size_);
     }
-    
-    // Aggiunge una stringa al buffer
-    std::string_view add(const std::string& value) {
-        // Cerca un blocco con spazio sufficiente
-        for (auto& block : blocks) {
-            if (block.can_fit(value.size())) {
-                return block.add_string(value);
-            }
+
+    ~StringBuffer() {
+        for (auto& block : blocks_) {
+            std::free(block.data);
         }
-        
-        // Se arriviamo qui, nessun blocco esistente ha spazio sufficiente
-        // Crea un nuovo blocco della dimensione fissa
-        blocks.emplace_back(block_size);
-        
-        // Se la stringa è più grande della dimensione del blocco, potrebbe non entrare
-        auto result = blocks.back().add_string(value);
-        if (result.empty()) {
-            // In casi eccezionali, crea un blocco speciale per stringhe molto grandi
-            blocks.emplace_back(value.size() + 1);
-            return blocks.back().add_string(value);
+    }
+
+    StringBuffer(const StringBuffer&) = delete;
+    StringBuffer& operator=(const StringBuffer&) = delete;
+
+    // Copia `value` nell'arena
+    std::string_view add(std::string_view value) {
+        char* data = static_cast<char*>(allocate(value.size(), 1));
+        if (!value.empty()) {
+            std::memcpy(data, value.data(), value.size());
         }
-        
+        return std::string_view(data, value.size());
+    }
+
+    // Memoria grezza di `size` byte allineata ad `align` (potenza di 2)
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(cur_) + align - 1) & ~(uintptr_t(align) - 1);
+        if (aligned + size > reinterpret_cast<uintptr_t>(end_)) {
+            wasted_ += static_cast<size_t>(end_ - cur_);
+            addBlock(size + align);
+            aligned = (reinterpret_cast<uintptr_t>(cur_) + align - 1) & ~(uintptr_t(align) - 1);
+        }
+        char* result = reinterpret_cast<char*>(aligned);
+        wasted_ += static_cast<size_t>(result - cur_);
+        cur_ = result + size;
+        used_ += size;
         return result;
     }
-    
-    // Pulisce tutti i blocchi tranne il primo
+
+    // Rilascia tutto il contenuto; tiene solo il blocco piu' grande (senza azzerarlo)
     void clear() {
-        if (blocks.empty()) {
-            return;
+        if (blocks_.size() > 1) {
+            size_t largest = 0;
+            for (size_t i = 1; i < blocks_.size(); i++) {
+                if (blocks_[i].capacity > blocks_[largest].capacity) largest = i;
+            }
+            for (size_t i = 0; i < blocks_.size(); i++) {
+                if (i != largest) std::free(blocks_[i].data);
+            }
+            blocks_[0] = blocks_[largest];
+            blocks_.resize(1);
+            capacity_ = blocks_[0].capacity;
         }
-        
-        // Mantieni solo il primo blocco e puliscilo
-        Block first_block = std::move(blocks[0]);
-        first_block.clear();
-        
-        blocks.clear();
-        blocks.emplace_back(std::move(first_block));
+        cur_ = blocks_[0].data;
+        end_ = cur_ + blocks_[0].capacity;
+        used_ = 0;
+        wasted_ = 0;
     }
-    
-    // Restituisce la capacità totale del buffer
-    size_t capacity() const {
-        size_t total = 0;
-        for (const auto& block : blocks) {
-            total += block.capacity;
-        }
-        return total;
+
+    // Byte riservati in totale
+    size_t capacity() const { return capacity_; }
+    // Byte consegnati da add()/allocate()
+    size_t used() const { return used_; }
+    // Byte persi: padding di allineamento e code dei blocchi abbandonati
+    size_t wasted() const { return wasted_; }
+    // Frazione dello spazio consumato che e' andata persa
+    double fragmentation() const {
+        return used_ + wasted_ == 0 ? 0.0 : static_cast<double>(wasted_) / static_cast<double>(used_ + wasted_);
     }
-    
-    // Restituisce lo spazio totale utilizzato
-    size_t used() const {
-        size_t total = 0;
-        for (const auto& block : blocks) {
-            total += block.used;
+    size_t block_count() const { return blocks_.size(); }
+
+private:
+    struct Block {
+        char* data;
+        size_t capacity;
+    };
+
+    void addBlock(size_t min_size) {
+        size_t size = next_block_size_;
+        while (size < min_size) size *= 2;
+        char* data = static_cast<char*>(std::malloc(size));
+        if (!data) {
+            throw std::bad_alloc();
         }
-        return total;
-    }
-    
-    // Restituisce il numero di blocchi di memoria
-    size_t block_count() const {
-        return blocks.size();
+        blocks_.push_back(Block{data, size});
+        capacity_ += size;
+        cur_ = data;
+        end_ = data + size;
+        if (next_block_size_ < kMaxBlockSize) next_block_size_ = std::min(size * 2, kMaxBlockSize);
     }
+
+    std::vector<Block> blocks_;
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+    size_t next_block_size_;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+    size_t wasted_ = 0;
 };
 
 } // namespace lazyjson
 
-#endif // LAZYJSON_STRING_BUFFER_HPP
\ No newline at end of file
+#endif // LAZYJSON_STRING_BUFFER_HPP
@@ -0,0 +1,48 @@
+#ifndef LAZYJSON_TAPE_UTIL_HPP
+#define LAZYJSON_TAPE_UTIL_HPP
+
+#include "tokenizer.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lazyjson {
+
+    // Internal helpers shared by the modules that walk the token tape directly
+    // (canonical, diff, schema, reduce, columnar); not part of the public API.
+    namespace tape_detail {
+
+        // Last token of the value starting at `index`: the matching bracket of a
+        // container, read from `jumps` when it covers the tape and found by a bracket
+        // scan otherwise. `index` itself for a scalar and for an unbalanced container.
+        size_t valueEnd(const std::vector<Token>& tokens, const std::vector<size_t>& jumps, size_t index);
+
+        // Value of a number token. Short integers are accumulated directly, the rest
+        // goes through from_chars, with strtod for what it refuses (out of range
+        // values saturate). False when `text` is not entirely a number.
+        bool parseNumber(std::string_view text, double& out);
+
+        inline double numberValue(std::string_view text) {
+            double value = 0;
+            parseNumber(text, value);
+            return value;
+        }
+
+        // Canonical text of a number token whose value is an integer, in any notation
+        // ("12", "1.20e1" and "120e-1" all give "12e0"): the significant digits and
+        // a power of ten, so that integers of any size compare exactly. False for a
+        // fractional value (or a malformed token), which only a double can represent.
+        bool integerText(std::string_view text, std::string& out);
+
+        // Equality of two number tokens: exact for integers, as doubles otherwise
+        bool sameNumber(std::string_view a, std::string_view b);
+
+        // String token payload with escapes decoded. Returns `escaped` itself when it
+        // has none (or is malformed), otherwise a view of `scratch`, which is overwritten.
+        std::string_view decoded(std::string_view escaped, std::string& scratch);
+
+    } // namespace tape_detail
+
+} // namespace lazyjson
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef LAZYJSON_TOKENIZER_HPP
 #define LAZYJSON_TOKENIZER_HPP
 
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -43,14 +44,68 @@ namespace lazyjson {
         Tokenizer(){}
         int tokenize(std::string_view, TokenizerError&);
         std::vector<Token> getTokens();
+        // Exchange the token vector with `tokens` (no copy, both keep their capacity)
+        inline void swapTokens(std::vector<Token>& tokens) { tokens_.swap(tokens); }
+        inline size_t capacity() const { return tokens_.capacity(); }
+        // Byte offset where the last failed tokenize() stopped
+        inline size_t errorOffset() const { return error_offset_; }
         std::string toString() const;
 
     private:
         void skipWhitespace(std::string_view::iterator& it);
-        std::string_view::iterator findStringEnd(std::string_view::iterator start);
+        std::string_view::iterator findStringEnd(std::string_view::iterator start, std::string_view::iterator end);
 
         std::vector<Token> tokens_;
-        std::string_view jsonString_;
+        size_t error_offset_ = 0;
+    };
+
+    // Resumable tokenizer for input arriving in chunks. Every chunk is appended to
+    // an owned buffer and scanned right away; a string, number or literal split
+    // across two chunks is resumed where the previous scan stopped. The matching
+    // bracket of every container is tracked as well (same layout as computeJumps
+    // in sidecar.hpp), so the tape is complete as soon as the input ends.
+    class StreamTokenizer {
+    public:
+        // Size the buffer for the whole input when it is known (e.g. Content-Length)
+        void reserve(size_t bytes);
+        // Append a chunk and tokenize it as far as possible
+        int feed(std::string_view chunk, TokenizerError&);
+        // End of input: complete a trailing number and add <EOF>
+        int finish(TokenizerError&);
+
+        // Move out the tokens (pointing into buffer(), valid until the next feed()
+        // or clear()) and jumps
+        void takeTokens(std::vector<Token>& tokens, std::vector<size_t>& jumps);
+
+        inline const std::string& buffer() const { return buffer_; }
+        inline bool started() const { return started_; }
+        inline bool finished() const { return finished_; }
+        inline size_t tokenCount() const { return tokens_.size(); }
+        // Byte offset in buffer() where the last failed feed()/finish() stopped
+        inline size_t errorOffset() const { return error_offset_; }
+
+        // Forget the document, keeping the allocated capacity
+        void clear();
+
+    private:
+        enum class State { VALUE, STRING, NUMBER, LITERAL };
+
+        int scan(bool final, TokenizerError&);
+        void push(TokenType type, size_t offset, size_t length);
+        // Reallocate the buffer and rebase the tokens already produced
+        void grow(size_t required);
+
+        std::string buffer_;
+        std::vector<Token> tokens_;
+        std::vector<size_t> jumps_;
+        std::vector<size_t> open_;
+        size_t pos_ = 0;
+        size_t token_start_ = 0;
+        State state_ = State::VALUE;
+        std::string_view literal_;
+        size_t error_offset_ = 0;
+        bool started_ = false;
+        bool finished_ = false;
     };
 
 } // namespace lazyjson
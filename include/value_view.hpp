@@ -0,0 +1,118 @@
+#ifndef LAZYJSON_VALUE_VIEW_HPP
+#define LAZYJSON_VALUE_VIEW_HPP
+
+#include "parser.hpp"
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace lazyjson {
+
+    // Read-only view of one value of a parsed document: a parser pointer and
+    // the token index where the value starts. Navigation and iteration walk the
+    // token tape directly, so they never allocate nor create a DataElement; a
+    // view is trivially copyable and as cheap to pass around as a pointer.
+    // A view is valid as long as its parser holds the same document.
+    //
+    //     lazyjson::ValueView root(parser);
+    //     for (auto item : root["items"]) {
+    //         if (item["price"].asNumber() > 10) total += item["qty"].asInt64();
+    //     }
+    //     for (auto member : root["headers"]) std::cout << member.key() << "\n";
+    //
+    // Lookups of a missing key or index, or on a value of the wrong type, give
+    // an invalid view (valid() == false, type() == UNDEFINED) instead of
+    // throwing, so chains like root["a"]["b"][0] can be checked once at the end.
+    // The typed getters throw std::runtime_error on a type mismatch (and
+    // asInt64() on a number outside the int64 range).
+    class ValueView {
+    public:
+        class Iterator;
+
+        ValueView() = default;
+        // Root of the document
+        explicit ValueView(const Parser& parser);
+        ValueView(const Parser& parser, size_t token_index) : parser_(&parser), index_(token_index) {}
+
+        inline bool valid() const { return parser_ != nullptr; }
+        inline explicit operator bool() const { return valid(); }
+        inline const Parser* parser() const { return parser_; }
+        inline size_t tokenIndex() const { return index_; }
+
+        ElementType type() const;
+        inline bool isNull() const { return type() == ElementType::NULL_VALUE; }
+        inline bool isBoolean() const { return type() == ElementType::BOOLEAN; }
+        inline bool isNumber() const { return type() == ElementType::NUMBER; }
+        inline bool isString() const { return type() == ElementType::STRING; }
+        inline bool isObject() const { return type() == ElementType::OBJECT; }
+        inline bool isArray() const { return type() == ElementType::ARRAY; }
+
+        bool asBoolean() const;
+        double asNumber() const;
+        int64_t asInt64() const;
+        // String contents as found in the document (escapes not decoded, no copy)
+        std::string_view asRawString() const;
+        // String contents with escapes decoded
+        std::string asString() const;
+        // Raw JSON text of the value (quotes included for strings)
+        std::string_view raw() const;
+
+        // Key of this value when it is an object member (escapes not decoded), empty otherwise
+        std::string_view key() const;
+
+        // Member of an object / element of an array
+        ValueView operator[](std::string_view key) const;
+        ValueView operator[](size_t index) const;
+        inline ValueView operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+
+        // Number of members or elements (walks the container), 0 for scalars
+        size_t size() const;
+
+        // Members of an object or elements of an array, as views; empty for scalars
+        Iterator begin() const;
+        Iterator end() const;
+
+    private:
+        const Token& token() const;
+        // Closing bracket of this container (<EOF> when it is never closed)
+        size_t endIndex() const;
+
+        const Parser* parser_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    class ValueView::Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ValueView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ValueView*;
+        using reference = ValueView;
+
+        Iterator() = default;
+        // `index`: first token of the current member (its key) or element,
+        // `end`: closing bracket of the container
+        Iterator(const Parser* parser, size_t index, size_t end, bool object)
+            : parser_(parser), index_(index), end_(end), object_(object) {}
+
+        ValueView operator*() const;
+        Iterator& operator++();
+        inline Iterator operator++(int) { Iterator copy = *this; ++*this; return copy; }
+        inline bool operator==(const Iterator& other) const { return index_ == other.index_; }
+        inline bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const Parser* parser_ = nullptr;
+        size_t index_ = 0;
+        size_t end_ = 0;
+        bool object_ = false;
+    };
+
+    static_assert(std::is_trivially_copyable_v<ValueView>, "ValueView must stay trivially copyable");
+    static_assert(std::is_trivially_copyable_v<ValueView::Iterator>, "ValueView::Iterator must stay trivially copyable");
+
+} // namespace lazyjson
+
+#endif // LAZYJSON_VALUE_VIEW_HPP
@@ -0,0 +1,171 @@
+#include "array_reader.hpp"
+#include <cstring>
+
+namespace lazyjson {
+
+namespace {
+    // Consumed input released from the page cache mapping at this granularity
+    constexpr size_t kDiscardStep = 64 * 1024 * 1024;
+
+    inline bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+}
+
+bool ArrayReader::openFile(const std::string& path) {
+    auto file = std::make_unique<MappedFile>();
+    TapeError error = TapeError::NONE;
+    if (file->open(path, error) != 0) {
+        file_.reset();
+        data_ = {};
+        done_ = true;
+        return fail(ArrayReaderError::IO_ERROR);
+    }
+    file->adviseSequential();
+    data_ = file->view();
+    file_ = std::move(file);
+    return start();
+}
+
+bool ArrayReader::openBuffer(std::string_view data) {
+    file_.reset();
+    data_ = data;
+    return start();
+}
+
+bool ArrayReader::start() {
+    current_ = {};
+    index_ = 0;
+    discarded_ = 0;
+    error_ = ArrayReaderError::NONE;
+    done_ = false;
+    pos_ = skipWhitespace(0);
+    if (pos_ >= data_.size() || data_[pos_] != '[') {
+        return fail(ArrayReaderError::NOT_AN_ARRAY);
+    }
+    pos_++;
+    return true;
+}
+
+bool ArrayReader::fail(ArrayReaderError error) {
+    error_ = error;
+    done_ = true;
+    current_ = {};
+    return false;
+}
+
+size_t ArrayReader::skipWhitespace(size_t pos) const {
+    while (pos < data_.size() && isSpace(data_[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+size_t ArrayReader::scanValue(size_t pos) const {
+    const char* data = data_.data();
+    const size_t size = data_.size();
+    size_t depth = 0;
+    while (pos < size) {
+        const char c = data[pos];
+        switch (c) {
+            case '"': {
+                // Closing quote: not preceded by an odd number of backslashes
+                size_t end = pos + 1;
+                while (true) {
+                    const void* quote = std::memchr(data + end, '"', size - end);
+                    if (!quote) return std::string_view::npos;
+                    end = static_cast<size_t>(static_cast<const char*>(quote) - data);
+                    size_t backslashes = 0;
+                    while (data[end - backslashes - 1] == '\\') backslashes++;
+                    if (backslashes % 2 == 0) break;
+                    end++;
+                }
+                pos = end + 1;
+                if (depth == 0) return pos;
+                continue;
+            }
+            case '{':
+            case '[':
+                depth++;
+                break;
+            case '}':
+            case ']':
+                if (depth == 0) return pos; // End of the enclosing array
+                if (--depth == 0) return pos + 1;
+                break;
+            case ',':
+                if (depth == 0) return pos;
+                break;
+            default:
+                if (depth == 0 && isSpace(c)) return pos;
+                break;
+        }
+        pos++;
+    }
+    return depth == 0 ? pos : std::string_view::npos;
+}
+
+bool ArrayReader::next() {
+    if (done_) {
+        return false;
+    }
+    pos_ = skipWhitespace(pos_);
+    if (index_ > 0) {
+        // Separator after the previous element
+        if (pos_ < data_.size() && data_[pos_] == ',') {
+            pos_ = skipWhitespace(pos_ + 1);
+        } else if (pos_ < data_.size() && data_[pos_] == ']') {
+            done_ = true;
+            current_ = {};
+            return false;
+        } else {
+            return fail(ArrayReaderError::MALFORMED);
+        }
+    } else if (pos_ < data_.size() && data_[pos_] == ']') {
+        done_ = true;
+        return false;
+    }
+
+    const size_t end = scanValue(pos_);
+    if (end == std::string_view::npos || end == pos_) {
+        return fail(ArrayReaderError::MALFORMED);
+    }
+    current_ = data_.substr(pos_, end - pos_);
+    pos_ = end;
+    index_++;
+
+    if (!parser_.parse(current_)) {
+        return fail(ArrayReaderError::PARSE_ERROR);
+    }
+
+    // Pages before the current element will not be read again
+    if (file_ && current_.data() - data_.data() >= static_cast<std::ptrdiff_t>(discarded_ + kDiscardStep)) {
+        discarded_ = static_cast<size_t>(current_.data() - data_.data());
+        file_->discard(discarded_);
+    }
+    return true;
+}
+
+std::ostream& operator<<(std::ostream& os, const ArrayReaderError& error) {
+    switch (error) {
+        case ArrayReaderError::NONE:
+            os << "NONE";
+            break;
+        case ArrayReaderError::IO_ERROR:
+            os << "IO_ERROR";
+            break;
+        case ArrayReaderError::NOT_AN_ARRAY:
+            os << "NOT_AN_ARRAY";
+            break;
+        case ArrayReaderError::MALFORMED:
+            os << "MALFORMED";
+            break;
+        case ArrayReaderError::PARSE_ERROR:
+            os << "PARSE_ERROR";
+            break;
+        default:
+            os << "UNKNOWN_ERROR";
+            break;
+    }
+    return os;
+}
+
+} // namespace lazyjson
@@ -0,0 +1,244 @@
+#include "canonical.hpp"
+#include "tape_util.hpp"
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+
+namespace lazyjson {
+
+namespace {
+
+    using tape_detail::decoded;
+    using tape_detail::numberValue;
+
+    // Independent seeds of the two lanes
+    constexpr uint64_t kSeedLow = 0x243F6A8885A308D3ULL;
+    constexpr uint64_t kSeedHigh = 0x13198A2E03707344ULL;
+
+    // Type tags, so that e.g. "1" and 1, or [] and {} never collide
+    constexpr uint64_t kTagNull = 0x6E756C6CULL;
+    constexpr uint64_t kTagTrue = 0x74727565ULL;
+    constexpr uint64_t kTagFalse = 0x66616C73ULL;
+    constexpr uint64_t kTagNumber = 0x6E756D62ULL;
+    constexpr uint64_t kTagInteger = 0x696E7465ULL;
+    constexpr uint64_t kTagString = 0x73747269ULL;
+    constexpr uint64_t kTagArray = 0x61727261ULL;
+    constexpr uint64_t kTagObject = 0x6F626A65ULL;
+
+    constexpr uint64_t kMul = 0x9E3779B97F4A7C15ULL;
+
+    inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    inline Hash128 tagged(uint64_t tag) {
+        return {hashMix(kSeedLow ^ tag), hashMix(kSeedHigh ^ tag)};
+    }
+
+    inline Hash128 hashText(std::string_view text, uint64_t tag) {
+        return {hashBytes(text, kSeedLow ^ tag), hashBytes(text, kSeedHigh ^ tag)};
+    }
+
+    class Hasher {
+    public:
+        explicit Hasher(const std::vector<Token>& tokens) : tokens_(tokens) {}
+
+        // Hash of the value at `index`; moves `index` past its last token
+        Hash128 value(size_t& index) {
+            const Token& token = tokens_[index++];
+            switch (token.type) {
+                case TokenType::TOKEN_NULL:
+                    return tagged(kTagNull);
+                case TokenType::TOKEN_BOOLEAN:
+                    return tagged(token.value == "true" ? kTagTrue : kTagFalse);
+                case TokenType::TOKEN_NUMBER: {
+                    // Integers by exact value, whatever their size or spelling
+                    if (tape_detail::integerText(token.value, scratch_)) {
+                        return hashText(scratch_, kTagInteger);
+                    }
+                    const double number = numberValue(token.value);
+                    return hashText(std::string_view(reinterpret_cast<const char*>(&number), sizeof(number)), kTagNumber);
+                }
+                case TokenType::TOKEN_STRING:
+                    return hashText(decoded(token.value, scratch_), kTagString);
+                case TokenType::TOKEN_ARRAY_START:
+                    return array(index);
+                case TokenType::TOKEN_OBJECT_START:
+                    return object(index);
+                default:
+                    throw std::runtime_error("Unexpected token while hashing");
+            }
+        }
+
+    private:
+        // Ordered: each element is folded into the running state
+        Hash128 array(size_t& index) {
+            Hash128 hash = tagged(kTagArray);
+            uint64_t count = 0;
+            while (tokens_[index].type != TokenType::TOKEN_ARRAY_END) {
+                if (tokens_[index].type == TokenType::TOKEN_COMMA) {
+                    index++;
+                    continue;
+                }
+                const Hash128 element = value(index);
+                hash.low = hashMix((hash.low ^ element.low) * kMul + count);
+                hash.high = hashMix((hash.high ^ element.high) * kMul + count);
+                count++;
+            }
+            index++;
+            return {hashMix(hash.low ^ count), hashMix(hash.high ^ count)};
+        }
+
+        // Order independent: members are hashed on their own and summed
+        Hash128 object(size_t& index) {
+            uint64_t low = 0, high = 0, count = 0;
+            while (tokens_[index].type != TokenType::TOKEN_OBJECT_END) {
+                if (tokens_[index].type == TokenType::TOKEN_COMMA) {
+                    index++;
+                    continue;
+                }
+                const Hash128 key = hashText(decoded(tokens_[index].value, scratch_), kTagString);
+                index += 2;  // key, ':'
+                const Hash128 member = value(index);
+                low += hashMix(key.low ^ rotl(member.low, 23) * kMul);
+                high += hashMix(key.high ^ rotl(member.high, 23) * kMul);
+                count++;
+            }
+            index++;
+            const Hash128 tag = tagged(kTagObject);
+            return {hashMix(tag.low ^ low ^ count * kMul), hashMix(tag.high ^ high ^ count * kMul)};
+        }
+
+        const std::vector<Token>& tokens_;
+        std::string scratch_;
+    };
+
+    // One side of an equality check
+    struct Side {
+        const std::vector<Token>& tokens;
+        const std::vector<size_t>& jumps;
+
+        explicit Side(const Parser& parser) : tokens(parser.getTokens()), jumps(parser.getTokenJumps()) {}
+
+        // Last token of the value starting at `index`
+        size_t end(size_t index) const { return tape_detail::valueEnd(tokens, jumps, index); }
+
+        // Raw text of the value starting at `index`, quotes included
+        std::string_view raw(size_t index) const {
+            const Token& first = tokens[index];
+            const Token& last = tokens[end(index)];
+            const char* begin = first.value.data();
+            const char* stop = last.value.data() + last.value.size();
+            if (first.type == TokenType::TOKEN_STRING) {
+                begin--;
+                stop++;
+            }
+            return std::string_view(begin, static_cast<size_t>(stop - begin));
+        }
+    };
+
+    bool equalValues(const Side& a, size_t index_a, const Side& b, size_t index_b) {
+        const std::string_view raw_a = a.raw(index_a);
+        const std::string_view raw_b = b.raw(index_b);
+        if (raw_a.size() == raw_b.size() && std::memcmp(raw_a.data(), raw_b.data(), raw_a.size()) == 0) {
+            return true;
+        }
+        const Token& token_a = a.tokens[index_a];
+        const Token& token_b = b.tokens[index_b];
+        if (token_a.type != token_b.type) {
+            return false;
+        }
+        switch (token_a.type) {
+            case TokenType::TOKEN_NULL:
+                return true;
+            case TokenType::TOKEN_BOOLEAN:
+                return token_a.value == token_b.value;
+            case TokenType::TOKEN_NUMBER:
+                return tape_detail::sameNumber(token_a.value, token_b.value);
+            case TokenType::TOKEN_STRING: {
+                std::string scratch_a, scratch_b;
+                return decoded(token_a.value, scratch_a) == decoded(token_b.value, scratch_b);
+            }
+            case TokenType::TOKEN_ARRAY_START: {
+                const size_t last_a = a.end(index_a), last_b = b.end(index_b);
+                size_t i = index_a + 1, j = index_b + 1;
+                while (true) {
+                    if (a.tokens[i].type == TokenType::TOKEN_COMMA) i++;
+                    if (b.tokens[j].type == TokenType::TOKEN_COMMA) j++;
+                    if (i == last_a || j == last_b) return i == last_a && j == last_b;
+                    if (!equalValues(a, i, b, j)) return false;
+                    i = a.end(i) + 1;
+                    j = b.end(j) + 1;
+                }
+            }
+            case TokenType::TOKEN_OBJECT_START: {
+                // Members of `b` by decoded key (keys with escapes are rare)
+                std::unordered_map<std::string_view, size_t> members_b;
+                std::deque<std::string> decoded_keys;
+                const size_t last_b = b.end(index_b);
+                for (size_t j = index_b + 1; j < last_b; j = b.end(j + 2) + 1) {
+                    if (b.tokens[j].type == TokenType::TOKEN_COMMA) j++;
+                    std::string_view key = b.tokens[j].value;
+                    if (key.find('\\') != std::string_view::npos) {
+                        decoded_keys.emplace_back();
+                        key = decoded(key, decoded_keys.back());
+                    }
+                    members_b[key] = j + 2;
+                }
+
+                const size_t last_a = a.end(index_a);
+                size_t count_a = 0;
+                std::string scratch;
+                for (size_t i = index_a + 1; i < last_a; i = a.end(i + 2) + 1) {
+                    if (a.tokens[i].type == TokenType::TOKEN_COMMA) i++;
+                    auto it = members_b.find(decoded(a.tokens[i].value, scratch));
+                    if (it == members_b.end() || !equalValues(a, i + 2, b, it->second)) return false;
+                    count_a++;
+                }
+                return count_a == members_b.size();
+            }
+            default:
+                return false;
+        }
+    }
+
+} // namespace
+
+Hash128 canonicalHash(const Parser& parser, size_t token_index) {
+    const auto& tokens = parser.getTokens();
+    if (token_index == 0 || token_index + 1 >= tokens.size()) {
+        return Hash128{};
+    }
+    Hasher hasher(tokens);
+    return hasher.value(token_index);
+}
+
+Hash128 canonicalHash(const Parser& parser, DataElement& element) {
+    if (!element.hasCanonicalHash()) {
+        element.setCanonicalHash(canonicalHash(parser, element.getTokenIndexStart()));
+    }
+    return element.getCanonicalHash();
+}
+
+Hash128 canonicalHash(const Parser& parser) {
+    const auto root = parser.getRoot();
+    return root ? canonicalHash(parser, *root) : Hash128{};
+}
+
+bool canonicalEqual(const Parser& a, const DataElement& element_a, const Parser& b, const DataElement& element_b) {
+    if (element_a.hasCanonicalHash() && element_b.hasCanonicalHash()
+        && element_a.getCanonicalHash() != element_b.getCanonicalHash()) {
+        return false;
+    }
+    const Side side_a(a), side_b(b);
+    const size_t index_a = element_a.getTokenIndexStart(), index_b = element_b.getTokenIndexStart();
+    if (index_a == 0 || index_a + 1 >= side_a.tokens.size() || index_b == 0 || index_b + 1 >= side_b.tokens.size()) {
+        return false;
+    }
+    return equalValues(side_a, index_a, side_b, index_b);
+}
+
+bool canonicalEqual(const Parser& a, const Parser& b) {
+    const auto root_a = a.getRoot(), root_b = b.getRoot();
+    return root_a && root_b && canonicalEqual(a, *root_a, b, *root_b);
+}
+
+} // namespace lazyjson
@@ -0,0 +1,402 @@
+#include "columnar.hpp"
+#include "tape_util.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace lazyjson {
+
+namespace {
+
+    // Below this size a single thread is faster than starting others
+    constexpr size_t kMinBytesPerThread = 1024 * 1024;
+
+    inline void appendBit(std::vector<uint8_t>& bitmap, size_t position, bool value) {
+        if ((position & 7) == 0) bitmap.push_back(0);
+        if (value) bitmap.back() |= static_cast<uint8_t>(1u << (position & 7));
+    }
+
+    // Bits [0, count) of `source` after the first `position` bits of `target`
+    void appendBits(std::vector<uint8_t>& target, size_t position, const std::vector<uint8_t>& source, size_t count) {
+        if ((position & 7) == 0) {
+            target.insert(target.end(), source.begin(), source.begin() + static_cast<std::ptrdiff_t>((count + 7) / 8));
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            appendBit(target, position + i, (source[i >> 3] >> (i & 7)) & 1);
+        }
+    }
+
+    bool parseInt64(std::string_view text, int64_t& out) {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+        if (result.ec == std::errc() && result.ptr == text.data() + text.size()) {
+            return true;
+        }
+        // 3.0, 1e3: integral values in another notation
+        double value = 0;
+        if (!tape_detail::parseNumber(text, value) || value != std::floor(value) || !(std::fabs(value) < 9.2e18)) {
+            return false;
+        }
+        out = static_cast<int64_t>(value);
+        return true;
+    }
+
+    // Moves `index` past the value starting there; false on a malformed tape
+    bool skipValue(const std::vector<Token>& tokens, size_t& index) {
+        switch (tokens[index].type) {
+            case TokenType::TOKEN_STRING:
+            case TokenType::TOKEN_NUMBER:
+            case TokenType::TOKEN_BOOLEAN:
+            case TokenType::TOKEN_NULL:
+                index++;
+                return true;
+            case TokenType::TOKEN_OBJECT_START:
+            case TokenType::TOKEN_ARRAY_START:
+                break;
+            default:
+                return false;
+        }
+        // Lines are tokenized without a jump table: valueEnd scans for the bracket
+        const size_t last = tape_detail::valueEnd(tokens, {}, index);
+        if (last == index) return false;
+        index = last + 1;
+        return true;
+    }
+
+} // namespace
+
+void Column::pushValidity(bool valid) {
+    appendBit(validity_, size_, valid);
+    if (!valid) null_count_++;
+}
+
+void Column::appendNull() {
+    pushValidity(false);
+    switch (type_) {
+        case ColumnType::BOOLEAN: appendBit(boolean_values_, size_, false); break;
+        case ColumnType::INT64: int64_values_.push_back(0); break;
+        case ColumnType::DOUBLE: double_values_.push_back(0); break;
+        case ColumnType::STRING: offsets_.push_back(static_cast<int64_t>(data_.size())); break;
+    }
+    size_++;
+}
+
+void Column::appendBoolean(bool value) {
+    pushValidity(true);
+    appendBit(boolean_values_, size_, value);
+    size_++;
+}
+
+void Column::appendInt64(int64_t value) {
+    pushValidity(true);
+    int64_values_.push_back(value);
+    size_++;
+}
+
+void Column::appendDouble(double value) {
+    pushValidity(true);
+    double_values_.push_back(value);
+    size_++;
+}
+
+void Column::appendString(std::string_view value) {
+    pushValidity(true);
+    data_.append(value.data(), value.size());
+    offsets_.push_back(static_cast<int64_t>(data_.size()));
+    size_++;
+}
+
+void Column::append(const Column& other) {
+    if (other.type_ != type_) {
+        throw std::runtime_error("Column type mismatch");
+    }
+    appendBits(validity_, size_, other.validity_, other.size_);
+    switch (type_) {
+        case ColumnType::BOOLEAN:
+            appendBits(boolean_values_, size_, other.boolean_values_, other.size_);
+            break;
+        case ColumnType::INT64:
+            int64_values_.insert(int64_values_.end(), other.int64_values_.begin(), other.int64_values_.end());
+            break;
+        case ColumnType::DOUBLE:
+            double_values_.insert(double_values_.end(), other.double_values_.begin(), other.double_values_.end());
+            break;
+        case ColumnType::STRING: {
+            const int64_t base = static_cast<int64_t>(data_.size());
+            offsets_.reserve(offsets_.size() + other.size_);
+            for (size_t i = 1; i < other.offsets_.size(); i++) {
+                offsets_.push_back(base + other.offsets_[i]);
+            }
+            data_.append(other.data_);
+            break;
+        }
+    }
+    size_ += other.size_;
+    null_count_ += other.null_count_;
+}
+
+void Column::reserve(size_t rows) {
+    validity_.reserve((rows + 7) / 8);
+    switch (type_) {
+        case ColumnType::BOOLEAN: boolean_values_.reserve((rows + 7) / 8); break;
+        case ColumnType::INT64: int64_values_.reserve(rows); break;
+        case ColumnType::DOUBLE: double_values_.reserve(rows); break;
+        case ColumnType::STRING: offsets_.reserve(rows + 1); break;
+    }
+}
+
+void Column::clear() {
+    size_ = 0;
+    null_count_ = 0;
+    validity_.clear();
+    int64_values_.clear();
+    double_values_.clear();
+    boolean_values_.clear();
+    offsets_.assign(1, 0);
+    data_.clear();
+}
+
+struct ColumnarExtractor::Batch {
+    std::vector<Column> columns;
+    size_t malformed = 0;
+    size_t rows = 0;
+};
+
+ColumnarExtractor::ColumnarExtractor(std::vector<ColumnSpec> specs) : specs_(std::move(specs)) {
+    trie_.emplace_back();
+    columns_.reserve(specs_.size());
+    for (size_t column = 0; column < specs_.size(); column++) {
+        const Path path(specs_[column].path);
+        uint32_t node = 0;
+        for (size_t i = 0; i < path.size(); i++) {
+            if (path.isWildcard(i)) {
+                throw std::runtime_error("Wildcards are not supported in column paths");
+            }
+            uint32_t child = 0;
+            for (uint32_t candidate : trie_[node].children) {
+                if (trie_[candidate].index == path.index(i) && trie_[candidate].key == path.key(i)) {
+                    child = candidate;
+                    break;
+                }
+            }
+            if (child == 0) {
+                child = static_cast<uint32_t>(trie_.size());
+                TrieNode created;
+                created.key = path.key(i);
+                created.index = path.index(i);
+                trie_.push_back(created);
+                trie_[node].children.push_back(child);
+            }
+            node = child;
+        }
+        if (trie_[node].column >= 0) {
+            throw std::runtime_error("Two columns with the same path: " + specs_[column].path);
+        }
+        trie_[node].column = static_cast<int>(column);
+        columns_.emplace_back(specs_[column].name, specs_[column].type);
+    }
+}
+
+bool ColumnarExtractor::walk(const std::vector<Token>& tokens, size_t& index, uint32_t node_id, std::vector<size_t>& hits) const {
+    const TrieNode& node = trie_[node_id];
+    const TokenType type = tokens[index].type;
+    if (node.column >= 0) {
+        hits[static_cast<size_t>(node.column)] = index;
+    }
+    if (node.children.empty() || (type != TokenType::TOKEN_OBJECT_START && type != TokenType::TOKEN_ARRAY_START)) {
+        return skipValue(tokens, index);
+    }
+
+    index++;
+    bool first = true;
+    if (type == TokenType::TOKEN_OBJECT_START) {
+        while (tokens[index].type != TokenType::TOKEN_OBJECT_END) {
+            if (!first) {
+                if (tokens[index].type != TokenType::TOKEN_COMMA) return false;
+                index++;
+            }
+            first = false;
+            if (tokens[index].type != TokenType::TOKEN_STRING || tokens[index + 1].type != TokenType::TOKEN_COLON) {
+                return false;
+            }
+            const std::string_view key = tokens[index].value;
+            index += 2;
+            uint32_t child = 0;
+            for (uint32_t candidate : node.children) {
+                if (trie_[candidate].index == Path::kNoIndex && trie_[candidate].key == key) {
+                    child = candidate;
+                    break;
+                }
+            }
+            if (!(child ? walk(tokens, index, child, hits) : skipValue(tokens, index))) return false;
+        }
+    } else {
+        size_t position = 0;
+        while (tokens[index].type != TokenType::TOKEN_ARRAY_END) {
+            if (!first) {
+                if (tokens[index].type != TokenType::TOKEN_COMMA) return false;
+                index++;
+            }
+            first = false;
+            uint32_t child = 0;
+            for (uint32_t candidate : node.children) {
+                if (trie_[candidate].index == position) {
+                    child = candidate;
+                    break;
+                }
+            }
+            if (!(child ? walk(tokens, index, child, hits) : skipValue(tokens, index))) return false;
+            position++;
+        }
+    }
+    index++;
+    return true;
+}
+
+void ColumnarExtractor::extractBatch(std::string_view input, Batch& batch) const {
+    batch.columns.clear();
+    for (const auto& spec : specs_) {
+        batch.columns.emplace_back(spec.name, spec.type);
+    }
+
+    Tokenizer tokenizer;
+    std::vector<Token> tokens;
+    std::vector<size_t> hits(specs_.size());
+    std::string scratch;
+
+    size_t pos = 0;
+    while (pos < input.size()) {
+        size_t end = input.find('\n', pos);
+        if (end == std::string_view::npos) end = input.size();
+        std::string_view line = input.substr(pos, end - pos);
+        pos = end + 1;
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) line.remove_suffix(1);
+        while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) line.remove_prefix(1);
+        if (line.empty()) continue;
+
+        std::fill(hits.begin(), hits.end(), SIZE_MAX);
+        TokenizerError error = TokenizerError::NONE;
+        bool valid = tokenizer.tokenize(line, error) == 0;
+        if (valid) {
+            tokenizer.swapTokens(tokens);
+            size_t index = 1;
+            valid = walk(tokens, index, 0, hits) && tokens[index].type == TokenType::TOKEN_EOF;
+        }
+        batch.rows++;
+        if (!valid) {
+            batch.malformed++;
+            for (auto& column : batch.columns) column.appendNull();
+            continue;
+        }
+
+        for (size_t c = 0; c < batch.columns.size(); c++) {
+            Column& column = batch.columns[c];
+            if (hits[c] == SIZE_MAX) {
+                column.appendNull();
+                continue;
+            }
+            const Token& token = tokens[hits[c]];
+            switch (column.type()) {
+                case ColumnType::BOOLEAN:
+                    if (token.type == TokenType::TOKEN_BOOLEAN) column.appendBoolean(token.value == "true");
+                    else column.appendNull();
+                    break;
+                case ColumnType::INT64: {
+                    int64_t value = 0;
+                    if (token.type == TokenType::TOKEN_NUMBER && parseInt64(token.value, value)) column.appendInt64(value);
+                    else column.appendNull();
+                    break;
+                }
+                case ColumnType::DOUBLE: {
+                    double value = 0;
+                    if (token.type == TokenType::TOKEN_NUMBER && tape_detail::parseNumber(token.value, value)) column.appendDouble(value);
+                    else column.appendNull();
+                    break;
+                }
+                case ColumnType::STRING:
+                    if (token.type == TokenType::TOKEN_STRING) column.appendString(tape_detail::decoded(token.value, scratch));
+                    else column.appendNull();
+                    break;
+            }
+        }
+    }
+}
+
+size_t ColumnarExtractor::extract(std::string_view ndjson, size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    threads = std::max<size_t>(1, std::min(threads, ndjson.size() / kMinBytesPerThread));
+
+    // Contiguous slices cut after a newline
+    std::vector<std::string_view> slices;
+    size_t start = 0;
+    for (size_t i = 1; i <= threads && start < ndjson.size(); i++) {
+        size_t end = i == threads ? ndjson.size() : ndjson.size() * i / threads;
+        if (end < start) end = start;
+        end = ndjson.find('\n', end);
+        end = end == std::string_view::npos ? ndjson.size() : end + 1;
+        slices.push_back(ndjson.substr(start, end - start));
+        start = end;
+    }
+
+    std::vector<Batch> batches(slices.size());
+    if (slices.size() == 1) {
+        extractBatch(slices[0], batches[0]);
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(slices.size());
+        for (size_t i = 0; i < slices.size(); i++) {
+            workers.emplace_back([this, &slices, &batches, i] { extractBatch(slices[i], batches[i]); });
+        }
+        for (auto& worker : workers) worker.join();
+    }
+
+    size_t appended = 0;
+    for (const auto& batch : batches) {
+        appended += batch.rows;
+    }
+    for (size_t c = 0; c < columns_.size(); c++) {
+        columns_[c].reserve(columns_[c].size() + appended);
+    }
+    for (auto& batch : batches) {
+        for (size_t c = 0; c < columns_.size(); c++) {
+            columns_[c].append(batch.columns[c]);
+        }
+        malformed_ += batch.malformed;
+    }
+    rows_ += appended;
+    return appended;
+}
+
+void ColumnarExtractor::clear() {
+    for (auto& column : columns_) column.clear();
+    rows_ = 0;
+    malformed_ = 0;
+}
+
+std::ostream& operator<<(std::ostream& os, const ColumnType& type) {
+    switch (type) {
+        case ColumnType::BOOLEAN:
+            os << "BOOLEAN";
+            break;
+        case ColumnType::INT64:
+            os << "INT64";
+            break;
+        case ColumnType::DOUBLE:
+            os << "DOUBLE";
+            break;
+        case ColumnType::STRING:
+            os << "STRING";
+            break;
+        default:
+            os << "UNKNOWN";
+            break;
+    }
+    return os;
+}
+
+} // namespace lazyjson
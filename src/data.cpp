@@ -35,6 +35,90 @@ namespace lazyjson {
         return escaped;
     }
 
+    namespace {
+        int hexValue(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        bool readHex4(std::string_view str, size_t pos, uint32_t& value) {
+            if (pos + 4 > str.size()) return false;
+            value = 0;
+            for (size_t i = pos; i < pos + 4; i++) {
+                int digit = hexValue(str[i]);
+                if (digit < 0) return false;
+                value = (value << 4) | static_cast<uint32_t>(digit);
+            }
+            return true;
+        }
+
+        void appendUtf8(std::string& out, uint32_t cp) {
+            if (cp < 0x80) {
+                out += static_cast<char>(cp);
+            } else if (cp < 0x800) {
+                out += static_cast<char>(0xC0 | (cp >> 6));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            } else if (cp < 0x10000) {
+                out += static_cast<char>(0xE0 | (cp >> 12));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (cp >> 18));
+                out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+        }
+    }
+
+    bool unescapeString(std::string_view str, std::string& out) {
+        out.clear();
+        out.reserve(str.size());
+        size_t i = 0;
+        while (i < str.size()) {
+            // Copy the run of plain characters up to the next escape in one go
+            size_t next = str.find('\\', i);
+            if (next == std::string_view::npos) {
+                out.append(str.data() + i, str.size() - i);
+                break;
+            }
+            out.append(str.data() + i, next - i);
+            if (next + 1 >= str.size()) return false;
+            char c = str[next + 1];
+            i = next + 2;
+            switch (c) {
+                case '"':  out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/':  out += '/'; break;
+                case 'b':  out += '\b'; break;
+                case 'f':  out += '\f'; break;
+                case 'n':  out += '\n'; break;
+                case 'r':  out += '\r'; break;
+                case 't':  out += '\t'; break;
+                case 'u': {
+                    uint32_t cp;
+                    if (!readHex4(str, i, cp)) return false;
+                    i += 4;
+                    // High surrogate followed by its low surrogate
+                    if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 <= str.size() && str[i] == '\\' && str[i + 1] == 'u') {
+                        uint32_t low;
+                        if (readHex4(str, i + 2, low) && low >= 0xDC00 && low <= 0xDFFF) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            i += 6;
+                        }
+                    }
+                    appendUtf8(out, cp);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        return true;
+    }
+
     std::ostream& operator<<(std::ostream& os, const ElementType& type) {
         switch (type) {
             case ElementType::NULL_VALUE:
@@ -0,0 +1,257 @@
+#include "diff.hpp"
+#include "sidecar.hpp"
+#include "tape_util.hpp"
+#include <cstring>
+#include <unordered_map>
+
+namespace lazyjson {
+
+namespace {
+
+    // Token tape of one side, with the matching bracket of every container
+    struct Tape {
+        const std::vector<Token>& tokens;
+        std::vector<size_t> local_jumps;
+        const std::vector<size_t>* jumps;
+
+        explicit Tape(const Parser& parser) : tokens(parser.getTokens()) {
+            jumps = &parser.getTokenJumps();
+            if (jumps->size() != tokens.size()) {
+                computeJumps(tokens, local_jumps);
+                jumps = &local_jumps;
+            }
+        }
+
+        // Last token of the value starting at `index`
+        size_t end(size_t index) const {
+            return tape_detail::valueEnd(tokens, *jumps, index);
+        }
+
+        // Raw text of the value starting at `index`, quotes included
+        std::string_view raw(size_t index) const {
+            const Token& first = tokens[index];
+            const Token& last = tokens[end(index)];
+            const char* begin = first.value.data();
+            const char* stop = last.value.data() + last.value.size();
+            if (first.type == TokenType::TOKEN_STRING) {
+                begin--;
+                stop++;
+            }
+            return std::string_view(begin, static_cast<size_t>(stop - begin));
+        }
+    };
+
+    // Token index of every member value of the object starting at `index`, in order
+    void members(const Tape& tape, size_t index, std::vector<std::pair<std::string_view, size_t>>& out) {
+        out.clear();
+        const size_t last = tape.end(index);
+        size_t i = index + 1;
+        while (i < last) {
+            if (tape.tokens[i].type == TokenType::TOKEN_COMMA) {
+                i++;
+                continue;
+            }
+            const std::string_view key = tape.tokens[i].value;
+            const size_t value = i + 2;  // key, ':'
+            out.emplace_back(key, value);
+            i = tape.end(value) + 1;
+        }
+    }
+
+    void elements(const Tape& tape, size_t index, std::vector<size_t>& out) {
+        out.clear();
+        const size_t last = tape.end(index);
+        size_t i = index + 1;
+        while (i < last) {
+            if (tape.tokens[i].type == TokenType::TOKEN_COMMA) {
+                i++;
+                continue;
+            }
+            out.push_back(i);
+            i = tape.end(i) + 1;
+        }
+    }
+
+    // JSON pointer reference token (RFC 6901) for an object key as found in the tape
+    std::string pointerToken(std::string_view escaped_key) {
+        std::string scratch;
+        const std::string_view key = tape_detail::decoded(escaped_key, scratch);
+        std::string token;
+        token.reserve(key.size());
+        for (char c : key) {
+            if (c == '~') token.append("~0");
+            else if (c == '/') token.append("~1");
+            else token.push_back(c);
+        }
+        return token;
+    }
+
+    class Differ {
+    public:
+        Differ(const Parser& from, const Parser& to, std::vector<PatchOperation>& out)
+            : from_(from), to_(to), out_(out) {}
+
+        void run() {
+            if (from_.tokens.size() < 3 || to_.tokens.size() < 3) {
+                if (to_.tokens.size() >= 3) emit(PatchOp::REPLACE, std::string(to_.raw(1)));
+                return;
+            }
+            compare(1, 1);
+        }
+
+    private:
+        void compare(size_t a, size_t b) {
+            const std::string_view raw_a = from_.raw(a);
+            const std::string_view raw_b = to_.raw(b);
+            // Identical bytes: the whole subtree is unchanged
+            if (raw_a.size() == raw_b.size() && std::memcmp(raw_a.data(), raw_b.data(), raw_a.size()) == 0) {
+                return;
+            }
+            const TokenType type_a = from_.tokens[a].type;
+            const TokenType type_b = to_.tokens[b].type;
+            if (type_a != type_b) {
+                emit(PatchOp::REPLACE, std::string(raw_b));
+                return;
+            }
+            switch (type_a) {
+                case TokenType::TOKEN_OBJECT_START:
+                    compareObjects(a, b);
+                    break;
+                case TokenType::TOKEN_ARRAY_START:
+                    compareArrays(a, b);
+                    break;
+                case TokenType::TOKEN_NUMBER:
+                    // Same value, different spelling (1.0 and 1, 1e2 and 100)
+                    if (!tape_detail::sameNumber(from_.tokens[a].value, to_.tokens[b].value)) {
+                        emit(PatchOp::REPLACE, std::string(raw_b));
+                    }
+                    break;
+                case TokenType::TOKEN_STRING:
+                    if (tape_detail::decoded(from_.tokens[a].value, scratch_a_) != tape_detail::decoded(to_.tokens[b].value, scratch_b_)) {
+                        emit(PatchOp::REPLACE, std::string(raw_b));
+                    }
+                    break;
+                default:
+                    emit(PatchOp::REPLACE, std::string(raw_b));
+                    break;
+            }
+        }
+
+        void compareObjects(size_t a, size_t b) {
+            std::vector<std::pair<std::string_view, size_t>> members_a, members_b;
+            members(from_, a, members_a);
+            members(to_, b, members_b);
+
+            std::unordered_map<std::string_view, size_t> index_b;
+            index_b.reserve(members_b.size());
+            for (const auto& [key, value] : members_b) {
+                index_b.emplace(key, value);
+            }
+
+            const size_t depth = path_.size();
+            for (const auto& [key, value] : members_a) {
+                path_.append("/").append(pointerToken(key));
+                auto it = index_b.find(key);
+                if (it == index_b.end()) {
+                    emit(PatchOp::REMOVE, {});
+                } else {
+                    compare(value, it->second);
+                    index_b.erase(it);
+                }
+                path_.resize(depth);
+            }
+            // Members only present in `to`, in document order
+            for (const auto& [key, value] : members_b) {
+                if (index_b.find(key) == index_b.end()) continue;
+                path_.append("/").append(pointerToken(key));
+                emit(PatchOp::ADD, std::string(to_.raw(value)));
+                path_.resize(depth);
+                index_b.erase(key);
+            }
+        }
+
+        void compareArrays(size_t a, size_t b) {
+            std::vector<size_t> elements_a, elements_b;
+            elements(from_, a, elements_a);
+            elements(to_, b, elements_b);
+
+            const size_t depth = path_.size();
+            const size_t common = std::min(elements_a.size(), elements_b.size());
+            for (size_t i = 0; i < common; i++) {
+                path_.append("/").append(std::to_string(i));
+                compare(elements_a[i], elements_b[i]);
+                path_.resize(depth);
+            }
+            for (size_t i = elements_a.size(); i > common; i--) {
+                path_.append("/").append(std::to_string(i - 1));
+                emit(PatchOp::REMOVE, {});
+                path_.resize(depth);
+            }
+            for (size_t i = common; i < elements_b.size(); i++) {
+                path_.append("/").append(std::to_string(i));
+                emit(PatchOp::ADD, std::string(to_.raw(elements_b[i])));
+                path_.resize(depth);
+            }
+        }
+
+        void emit(PatchOp op, std::string value) {
+            out_.push_back(PatchOperation{op, path_, std::move(value)});
+        }
+
+        Tape from_;
+        Tape to_;
+        std::vector<PatchOperation>& out_;
+        std::string path_;
+        // Decoded strings of the two sides, reused across comparisons
+        std::string scratch_a_;
+        std::string scratch_b_;
+    };
+
+} // namespace
+
+std::vector<PatchOperation> diff(const Parser& from, const Parser& to) {
+    std::vector<PatchOperation> operations;
+    Differ(from, to, operations).run();
+    return operations;
+}
+
+std::string toJsonPatch(const std::vector<PatchOperation>& operations) {
+    std::string patch = "[";
+    for (size_t i = 0; i < operations.size(); i++) {
+        const auto& operation = operations[i];
+        if (i > 0) patch.push_back(',');
+        patch.append("{\"op\":\"");
+        switch (operation.op) {
+            case PatchOp::ADD: patch.append("add"); break;
+            case PatchOp::REMOVE: patch.append("remove"); break;
+            case PatchOp::REPLACE: patch.append("replace"); break;
+        }
+        patch.append("\",\"path\":\"").append(escapeString(operation.path)).append("\"");
+        if (operation.op != PatchOp::REMOVE) {
+            patch.append(",\"value\":").append(operation.value);
+        }
+        patch.push_back('}');
+    }
+    patch.push_back(']');
+    return patch;
+}
+
+std::ostream& operator<<(std::ostream& os, const PatchOp& op) {
+    switch (op) {
+        case PatchOp::ADD:
+            os << "add";
+            break;
+        case PatchOp::REMOVE:
+            os << "remove";
+            break;
+        case PatchOp::REPLACE:
+            os << "replace";
+            break;
+        default:
+            os << "unknown";
+            break;
+    }
+    return os;
+}
+
+} // namespace lazyjson
@@ -0,0 +1,127 @@
+#include "document_cache.hpp"
+#include <cstring>
+
+namespace lazyjson {
+
+namespace {
+
+    // Cache key of an input: its hash and its length, as raw bytes
+    struct ContentKey {
+        char bytes[16];
+
+        ContentKey(uint64_t hash, size_t length) {
+            const uint64_t size = length;
+            std::memcpy(bytes, &hash, 8);
+            std::memcpy(bytes + 8, &size, 8);
+        }
+
+        inline std::string_view view() const { return std::string_view(bytes, sizeof(bytes)); }
+    };
+
+} // namespace
+
+CachedDocument::CachedDocument(std::string_view source, uint64_t hash, size_t max_memo_entries,
+                               std::shared_ptr<ShapeCache> shape_cache)
+    : source_(source), hash_(hash), max_memo_entries_(max_memo_entries) {
+    parser_.setShapeCache(std::move(shape_cache));
+}
+
+size_t CachedDocument::resolve(std::string_view path) const {
+    const Path split(path);
+    ValueView view = root();
+    for (size_t i = 0; i < split.size() && view; i++) {
+        if (split.isWildcard(i)) {
+            return 0;
+        }
+        view = split.index(i) == Path::kNoIndex ? view[split.key(i)] : view[split.index(i)];
+    }
+    return view ? view.tokenIndex() : 0;
+}
+
+ValueView CachedDocument::find(std::string_view path) const {
+    if (max_memo_entries_ == 0) {
+        const size_t index = resolve(path);
+        return index ? ValueView(parser_, index) : ValueView();
+    }
+    const uint64_t path_hash = hashBytes(path);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = memo_.find(path_hash);
+        if (it != memo_.end() && it->second.first == path) {
+            return it->second.second ? ValueView(parser_, it->second.second) : ValueView();
+        }
+    }
+    // Resolved outside the lock: the tape is never modified
+    const size_t index = resolve(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (memo_.size() < max_memo_entries_) {
+        memo_.emplace(path_hash, std::make_pair(std::string(path), index));
+    }
+    return index ? ValueView(parser_, index) : ValueView();
+}
+
+int CachedDocument::get(const std::string& path, ElementPtr& element) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return parser_.get(path, element);
+}
+
+size_t CachedDocument::bytes() const {
+    return sizeof(CachedDocument) + source_.capacity() + parser_.retainedBytes();
+}
+
+DocumentCache::DocumentCache() : DocumentCache(Options{}) {}
+
+DocumentCache::DocumentCache(Options options)
+    : options_(std::move(options)), cache_(options_.capacity_bytes, options_.shards) {
+    if (!options_.shape_cache) {
+        options_.shape_cache = std::make_shared<ShapeCache>();
+    }
+}
+
+DocumentCache::DocumentPtr DocumentCache::lookup(std::string_view json, uint64_t hash) const {
+    DocumentPtr document;
+    if (!cache_.lookup(hash, ContentKey(hash, json.size()).view(), document)) {
+        return nullptr;
+    }
+    if (options_.verify_bytes && document->source() != json) {
+        return nullptr;
+    }
+    return document;
+}
+
+DocumentCache::DocumentPtr DocumentCache::find(std::string_view json) const {
+    return lookup(json, hashBytes(json));
+}
+
+DocumentCache::DocumentPtr DocumentCache::acquire(std::string_view json) {
+    const bool cached = json.size() >= options_.min_document_bytes;
+    const uint64_t hash = cached ? hashBytes(json) : 0;
+    if (cached) {
+        if (DocumentPtr document = lookup(json, hash)) {
+            return document;
+        }
+    }
+
+    // Not shared yet: the document is built without its lock
+    std::shared_ptr<CachedDocument> document(
+        new CachedDocument(json, hash, options_.max_memo_entries, options_.shape_cache));
+    if (!document->parser_.parse(std::string_view(document->source_))) {
+        return nullptr;
+    }
+    document->parser_.buildTokenJumps();
+    if (cached) {
+        // Two threads missing on the same bytes both parse them; the last insert wins
+        cache_.insert(hash, ContentKey(hash, json.size()).view(), document, document->bytes());
+    }
+    return document;
+}
+
+void DocumentCache::clear() {
+    cache_.clear();
+}
+
+CacheStats DocumentCache::stats() const {
+    return cache_.stats();
+}
+
+} // namespace lazyjson
@@ -0,0 +1,45 @@
+#include "error.hpp"
+
+namespace lazyjson {
+
+    std::ostream& operator<<(std::ostream& os, const ErrorKind& kind) {
+        switch (kind) {
+            case ErrorKind::NONE:
+                os << "NONE";
+                break;
+            case ErrorKind::UNTERMINATED_STRING:
+                os << "UNTERMINATED_STRING";
+                break;
+            case ErrorKind::UNEXPECTED_CHARACTER:
+                os << "UNEXPECTED_CHARACTER";
+                break;
+            case ErrorKind::UNEXPECTED_TOKEN:
+                os << "UNEXPECTED_TOKEN";
+                break;
+            case ErrorKind::UNEXPECTED_END:
+                os << "UNEXPECTED_END";
+                break;
+            case ErrorKind::IO_ERROR:
+                os << "IO_ERROR";
+                break;
+            case ErrorKind::INVALID_PATH:
+                os << "INVALID_PATH";
+                break;
+            case ErrorKind::KEY_NOT_FOUND:
+                os << "KEY_NOT_FOUND";
+                break;
+            case ErrorKind::NOT_A_CONTAINER:
+                os << "NOT_A_CONTAINER";
+                break;
+            default:
+                os << "UNKNOWN_ERROR";
+                break;
+        }
+        return os;
+    }
+
+    std::ostream& operator<<(std::ostream& os, const Error& error) {
+        return os << error.kind << " at offset " << error.offset;
+    }
+
+} // namespace lazyjson
@@ -0,0 +1,373 @@
+#include "exporter.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace lazyjson {
+
+    namespace {
+
+        // MessagePack type bytes
+        constexpr uint8_t MP_NIL = 0xc0, MP_FALSE = 0xc2, MP_TRUE = 0xc3, MP_FLOAT64 = 0xcb;
+        constexpr uint8_t MP_UINT8 = 0xcc, MP_UINT16 = 0xcd, MP_UINT32 = 0xce, MP_UINT64 = 0xcf;
+        constexpr uint8_t MP_INT8 = 0xd0, MP_INT16 = 0xd1, MP_INT32 = 0xd2, MP_INT64 = 0xd3;
+        constexpr uint8_t MP_STR8 = 0xd9, MP_STR16 = 0xda, MP_STR32 = 0xdb;
+        constexpr uint8_t MP_ARRAY16 = 0xdc, MP_ARRAY32 = 0xdd, MP_MAP16 = 0xde, MP_MAP32 = 0xdf;
+
+        // CBOR major types and simple values
+        constexpr uint8_t CBOR_UNSIGNED = 0, CBOR_NEGATIVE = 1, CBOR_TEXT = 3, CBOR_ARRAY = 4, CBOR_MAP = 5;
+        constexpr uint8_t CBOR_FALSE = 0xf4, CBOR_TRUE = 0xf5, CBOR_NULL = 0xf6, CBOR_FLOAT64 = 0xfb;
+
+        inline void putBigEndian(std::vector<uint8_t>& out, uint64_t value, size_t bytes) {
+            for (size_t i = bytes; i > 0; i--) {
+                out.push_back(static_cast<uint8_t>(value >> ((i - 1) * 8)));
+            }
+        }
+
+        inline bool isIntegerText(std::string_view text) {
+            for (char c : text) {
+                if (c == '.' || c == 'e' || c == 'E') return false;
+            }
+            return true;
+        }
+
+    } // namespace
+
+    int BinaryExporter::exportDocument(const Parser& parser, std::vector<uint8_t>& out) {
+        out_ = &out;
+        sink_ = nullptr;
+        encodeDocument(parser);
+        out_ = nullptr;
+        return 0;
+    }
+
+    int BinaryExporter::exportDocument(const Parser& parser, const ByteSink& sink, size_t chunk_size) {
+        std::vector<uint8_t> buffer;
+        buffer.reserve(chunk_size + 64);
+        out_ = &buffer;
+        sink_ = &sink;
+        chunk_size_ = chunk_size;
+        encodeDocument(parser);
+        if (!buffer.empty()) {
+            sink(buffer.data(), buffer.size());
+        }
+        out_ = nullptr;
+        sink_ = nullptr;
+        return 0;
+    }
+
+    void BinaryExporter::encodeDocument(const Parser& parser) {
+        const auto& tokens = parser.getTokens();
+        const auto root = parser.getRoot();
+        if (!root || tokens.size() < 3) {
+            throw std::runtime_error("Nothing to export: the parser holds no document");
+        }
+        countChildren(tokens);
+        encodeElement(parser, *root);
+    }
+
+    // Direct children of each container: a non empty container has one more child than
+    // the commas found at its own depth. Computed in one pass with an explicit stack.
+    void BinaryExporter::countChildren(const std::vector<Token>& tokens) {
+        child_count_.assign(tokens.size(), 0);
+        std::vector<size_t> open;
+        for (size_t i = 0; i < tokens.size(); i++) {
+            switch (tokens[i].type) {
+                case TokenType::TOKEN_OBJECT_START:
+                case TokenType::TOKEN_ARRAY_START: {
+                    const TokenType next = i + 1 < tokens.size() ? tokens[i + 1].type : TokenType::TOKEN_EOF;
+                    child_count_[i] = (next == TokenType::TOKEN_OBJECT_END || next == TokenType::TOKEN_ARRAY_END) ? 0 : 1;
+                    open.push_back(i);
+                    break;
+                }
+                case TokenType::TOKEN_OBJECT_END:
+                case TokenType::TOKEN_ARRAY_END:
+                    if (!open.empty()) open.pop_back();
+                    break;
+                case TokenType::TOKEN_COMMA:
+                    if (!open.empty()) child_count_[open.back()]++;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    void BinaryExporter::encodeElement(const Parser& parser, const DataElement& element) {
+        const auto& tokens = parser.getTokens();
+        if (!element.isModified()) {
+            // Same rule as Parser::dump: the token tape is authoritative for unmodified elements
+            encodeTokens(tokens, element.getTokenIndexStart());
+            return;
+        }
+        switch (element.getType()) {
+            case ElementType::NULL_VALUE:
+                writeNull();
+                break;
+            case ElementType::BOOLEAN:
+                writeBoolean(element.asBoolean());
+                break;
+            case ElementType::NUMBER: {
+                const double value = element.asNumber();
+                if (std::trunc(value) == value && std::fabs(value) < 9.0e18) {
+                    writeInteger(static_cast<int64_t>(value));
+                } else {
+                    writeDouble(value);
+                }
+                break;
+            }
+            case ElementType::STRING:
+                writeString(element.asString());
+                break;
+            case ElementType::OBJECT:
+            case ElementType::ARRAY: {
+                const bool is_object = element.getType() == ElementType::OBJECT;
+                const auto& keys = element.getElementKeyList();
+                if (is_object) writeMapHeader(keys.size()); else writeArrayHeader(keys.size());
+                for (const auto& key : keys) {
+                    if (is_object) writeString(key);
+                    if (element.isMaterializedElement(key)) {
+                        encodeElement(parser, *element.getMaterializedElement(key));
+                    } else {
+                        encodeTokens(tokens, element.getTokenIndex(key));
+                    }
+                    flushIfNeeded();
+                }
+                break;
+            }
+            default:
+                throw std::runtime_error("Trying to export an invalid data type object");
+        }
+    }
+
+    // Encode the value starting at `start` by scanning the tape once: containers
+    // emit their header, keys and scalars are written as they are met
+    void BinaryExporter::encodeTokens(const std::vector<Token>& tokens, size_t start) {
+        size_t depth = 0;
+        size_t i = start;
+        do {
+            if (i >= tokens.size()) {
+                throw std::runtime_error("Unexpected end of tokens");
+            }
+            const Token& token = tokens[i];
+            switch (token.type) {
+                case TokenType::TOKEN_OBJECT_START:
+                    writeMapHeader(child_count_[i]);
+                    depth++;
+                    break;
+                case TokenType::TOKEN_ARRAY_START:
+                    writeArrayHeader(child_count_[i]);
+                    depth++;
+                    break;
+                case TokenType::TOKEN_OBJECT_END:
+                case TokenType::TOKEN_ARRAY_END:
+                    depth--;
+                    break;
+                case TokenType::TOKEN_COLON:
+                case TokenType::TOKEN_COMMA:
+                    break;
+                case TokenType::TOKEN_STRING:
+                    writeString(token.value);
+                    break;
+                case TokenType::TOKEN_NUMBER:
+                    writeNumber(token.value);
+                    break;
+                case TokenType::TOKEN_BOOLEAN:
+                    writeBoolean(token.value == "true");
+                    break;
+                case TokenType::TOKEN_NULL:
+                    writeNull();
+                    break;
+                default:
+                    throw std::runtime_error("Unexpected token type");
+            }
+            flushIfNeeded();
+            i++;
+        } while (depth > 0);
+    }
+
+    void BinaryExporter::writeNull() {
+        out_->push_back(format_ == BinaryFormat::MESSAGEPACK ? MP_NIL : CBOR_NULL);
+    }
+
+    void BinaryExporter::writeBoolean(bool value) {
+        if (format_ == BinaryFormat::MESSAGEPACK) {
+            out_->push_back(value ? MP_TRUE : MP_FALSE);
+        } else {
+            out_->push_back(value ? CBOR_TRUE : CBOR_FALSE);
+        }
+    }
+
+    // Integers that fit 64 bits keep their integer encoding, everything else becomes a float64
+    void BinaryExporter::writeNumber(std::string_view text) {
+        const char* first = text.data();
+        const char* last = text.data() + text.size();
+        if (isIntegerText(text)) {
+            if (text[0] == '-') {
+                int64_t value;
+                auto result = std::from_chars(first, last, value);
+                if (result.ec == std::errc() && result.ptr == last) {
+                    writeInteger(value);
+                    return;
+                }
+            } else {
+                uint64_t value;
+                auto result = std::from_chars(first, last, value);
+                if (result.ec == std::errc() && result.ptr == last) {
+                    writeUnsigned(value);
+                    return;
+                }
+            }
+        }
+        double value;
+        auto result = std::from_chars(first, last, value);
+        if (result.ec == std::errc::result_out_of_range) {
+            // from_chars leaves the value untouched; strtod saturates to +-inf or 0
+            value = std::strtod(std::string(text).c_str(), nullptr);
+        } else if (result.ec != std::errc()) {
+            throw std::runtime_error("Invalid number: " + std::string(text));
+        }
+        writeDouble(value);
+    }
+
+    void BinaryExporter::writeDouble(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        out_->push_back(format_ == BinaryFormat::MESSAGEPACK ? MP_FLOAT64 : CBOR_FLOAT64);
+        putBigEndian(*out_, bits, 8);
+    }
+
+    void BinaryExporter::writeInteger(int64_t value) {
+        if (value >= 0) {
+            writeUnsigned(static_cast<uint64_t>(value));
+            return;
+        }
+        if (format_ == BinaryFormat::CBOR) {
+            // CBOR negative integers encode -1 - value
+            writeHeader(CBOR_NEGATIVE, static_cast<uint64_t>(-(value + 1)));
+            return;
+        }
+        if (value >= -32) {
+            out_->push_back(static_cast<uint8_t>(value));  // negative fixint
+        } else if (value >= std::numeric_limits<int8_t>::min()) {
+            out_->push_back(MP_INT8);
+            putBigEndian(*out_, static_cast<uint8_t>(value), 1);
+        } else if (value >= std::numeric_limits<int16_t>::min()) {
+            out_->push_back(MP_INT16);
+            putBigEndian(*out_, static_cast<uint16_t>(value), 2);
+        } else if (value >= std::numeric_limits<int32_t>::min()) {
+            out_->push_back(MP_INT32);
+            putBigEndian(*out_, static_cast<uint32_t>(value), 4);
+        } else {
+            out_->push_back(MP_INT64);
+            putBigEndian(*out_, static_cast<uint64_t>(value), 8);
+        }
+    }
+
+    void BinaryExporter::writeUnsigned(uint64_t value) {
+        if (format_ == BinaryFormat::CBOR) {
+            writeHeader(CBOR_UNSIGNED, value);
+            return;
+        }
+        if (value < 128) {
+            out_->push_back(static_cast<uint8_t>(value));  // positive fixint
+        } else if (value <= 0xff) {
+            out_->push_back(MP_UINT8);
+            putBigEndian(*out_, value, 1);
+        } else if (value <= 0xffff) {
+            out_->push_back(MP_UINT16);
+            putBigEndian(*out_, value, 2);
+        } else if (value <= 0xffffffffULL) {
+            out_->push_back(MP_UINT32);
+            putBigEndian(*out_, value, 4);
+        } else {
+            out_->push_back(MP_UINT64);
+            putBigEndian(*out_, value, 8);
+        }
+    }
+
+    void BinaryExporter::writeString(std::string_view json_escaped) {
+        std::string_view text = json_escaped;
+        if (json_escaped.find('\\') != std::string_view::npos) {
+            if (!unescapeString(json_escaped, unescaped_)) {
+                throw std::runtime_error("Invalid escape sequence in string");
+            }
+            text = unescaped_;
+        }
+        const size_t size = text.size();
+        if (format_ == BinaryFormat::CBOR) {
+            writeHeader(CBOR_TEXT, size);
+        } else if (size < 32) {
+            out_->push_back(static_cast<uint8_t>(0xa0 | size));  // fixstr
+        } else if (size <= 0xff) {
+            out_->push_back(MP_STR8);
+            putBigEndian(*out_, size, 1);
+        } else if (size <= 0xffff) {
+            out_->push_back(MP_STR16);
+            putBigEndian(*out_, size, 2);
+        } else {
+            out_->push_back(MP_STR32);
+            putBigEndian(*out_, size, 4);
+        }
+        out_->insert(out_->end(), text.begin(), text.end());
+    }
+
+    void BinaryExporter::writeArrayHeader(size_t size) {
+        if (format_ == BinaryFormat::CBOR) {
+            writeHeader(CBOR_ARRAY, size);
+        } else if (size < 16) {
+            out_->push_back(static_cast<uint8_t>(0x90 | size));  // fixarray
+        } else if (size <= 0xffff) {
+            out_->push_back(MP_ARRAY16);
+            putBigEndian(*out_, size, 2);
+        } else {
+            out_->push_back(MP_ARRAY32);
+            putBigEndian(*out_, size, 4);
+        }
+    }
+
+    void BinaryExporter::writeMapHeader(size_t size) {
+        if (format_ == BinaryFormat::CBOR) {
+            writeHeader(CBOR_MAP, size);
+        } else if (size < 16) {
+            out_->push_back(static_cast<uint8_t>(0x80 | size));  // fixmap
+        } else if (size <= 0xffff) {
+            out_->push_back(MP_MAP16);
+            putBigEndian(*out_, size, 2);
+        } else {
+            out_->push_back(MP_MAP32);
+            putBigEndian(*out_, size, 4);
+        }
+    }
+
+    // CBOR initial byte plus the shortest argument encoding
+    void BinaryExporter::writeHeader(uint8_t major, uint64_t value) {
+        const uint8_t type = static_cast<uint8_t>(major << 5);
+        if (value < 24) {
+            out_->push_back(static_cast<uint8_t>(type | value));
+        } else if (value <= 0xff) {
+            out_->push_back(type | 24);
+            putBigEndian(*out_, value, 1);
+        } else if (value <= 0xffff) {
+            out_->push_back(type | 25);
+            putBigEndian(*out_, value, 2);
+        } else if (value <= 0xffffffffULL) {
+            out_->push_back(type | 26);
+            putBigEndian(*out_, value, 4);
+        } else {
+            out_->push_back(type | 27);
+            putBigEndian(*out_, value, 8);
+        }
+    }
+
+    void BinaryExporter::flushIfNeeded() {
+        if (sink_ && out_->size() >= chunk_size_) {
+            (*sink_)(out_->data(), out_->size());
+            out_->clear();
+        }
+    }
+
+} // namespace lazyjson
@@ -0,0 +1,439 @@
+#include "format.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace lazyjson {
+
+namespace {
+
+    // Word-wide byte masks (SWAR): the high bit of every matching byte is set.
+    // All of them are exact, so a mask also tells which bytes do not match.
+    constexpr uint64_t kOnes = 0x0101010101010101ULL;
+    constexpr uint64_t kHigh = 0x8080808080808080ULL;
+
+    inline uint64_t load64(const char* p) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        return word;
+    }
+
+    inline uint64_t zeroBytes(uint64_t word) {
+        return ~(((word & ~kHigh) + ~kHigh) | word) & kHigh;
+    }
+
+    inline uint64_t equalBytes(uint64_t word, uint8_t c) {
+        return zeroBytes(word ^ (kOnes * c));
+    }
+
+    // Bytes lower than `n` (n <= 0x80)
+    inline uint64_t belowBytes(uint64_t word, uint8_t n) {
+        return ~(((word & ~kHigh) + kOnes * (0x80 - n)) | word) & kHigh;
+    }
+
+    // Offset of the first matching byte in memory order
+    inline size_t firstByte(uint64_t mask) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return static_cast<size_t>(__builtin_clzll(mask)) >> 3;
+#else
+        return static_cast<size_t>(__builtin_ctzll(mask)) >> 3;
+#endif
+    }
+
+    // Byte classes a run stops at. `mask` handles a word, `test` the tail bytes.
+    // Or-ing 0x20 folds '[' onto '{', ']' onto '}' and maps nothing else that is
+    // not whitespace onto '"', ',' or ':', so one compare covers two brackets.
+    struct StringStop {
+        static inline uint64_t mask(uint64_t word) {
+            return equalBytes(word, '"') | equalBytes(word, '\\');
+        }
+        static inline bool test(unsigned char c) { return c == '"' || c == '\\'; }
+    };
+
+    // Numbers and literals, for prettify: anything structural ends them
+    struct ScalarStop {
+        static inline uint64_t mask(uint64_t word) {
+            const uint64_t folded = word | (kOnes * 0x20);
+            return belowBytes(word, 0x21) | equalBytes(folded, '"') | equalBytes(folded, '{') | equalBytes(folded, '}')
+                 | equalBytes(folded, ',') | equalBytes(folded, ':');
+        }
+        static inline bool test(unsigned char c) {
+            return c <= 0x20 || c == '"' || (c | 0x20) == '{' || (c | 0x20) == '}' || c == ',' || c == ':';
+        }
+    };
+
+    // Caller buffer with snprintf semantics: what does not fit is only counted
+    class Output {
+    public:
+        Output(char* out, size_t capacity) : begin_(out), pos_(out), limit_(out + capacity) {}
+
+        // Room for an 8 byte store, of which only `advance` bytes are kept
+        inline bool hasWord() const { return limit_ - pos_ >= 8; }
+        inline void putWord(uint64_t word, size_t advance) {
+            std::memcpy(pos_, &word, 8);
+            pos_ += advance;
+        }
+
+        inline void put(char c) {
+            if (pos_ < limit_) {
+                *pos_++ = c;
+            } else {
+                overflow_++;
+            }
+        }
+
+        inline void put(const char* data, size_t size) {
+            const size_t room = static_cast<size_t>(limit_ - pos_);
+            const size_t copied = std::min(size, room);
+            if (copied > 0) {
+                std::memcpy(pos_, data, copied);
+            }
+            pos_ += copied;
+            overflow_ += size - copied;
+        }
+
+        void newline(size_t spaces) {
+            static const char kSpaces[64] = {
+                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '};
+            put('\n');
+            while (spaces > 0) {
+                const size_t chunk = std::min(spaces, sizeof(kSpaces));
+                put(kSpaces, chunk);
+                spaces -= chunk;
+            }
+        }
+
+        inline size_t total() const { return static_cast<size_t>(pos_ - begin_) + overflow_; }
+
+    private:
+        char* begin_;
+        char* pos_;
+        char* limit_;
+        size_t overflow_ = 0;
+    };
+
+    // Copy bytes up to the first one of class Stop (or the end), returning it.
+    // Whole words are stored speculatively and the output advanced by the
+    // bytes that belong to the run.
+    template<typename Stop>
+    const char* copyRun(const char* p, const char* end, Output& out) {
+        while (end - p >= 8 && out.hasWord()) {
+            const uint64_t word = load64(p);
+            const uint64_t mask = Stop::mask(word);
+            if (mask) {
+                const size_t run = firstByte(mask);
+                out.putWord(word, run);
+                return p + run;
+            }
+            out.putWord(word, 8);
+            p += 8;
+        }
+        const char* q = p;
+        while (q < end && !Stop::test(static_cast<unsigned char>(*q))) q++;
+        out.put(p, static_cast<size_t>(q - p));
+        return q;
+    }
+
+    const char* skipSpace(const char* p, const char* end) {
+        while (end - p >= 8) {
+            const uint64_t mask = ~belowBytes(load64(p), 0x21) & kHigh;
+            if (mask) return p + firstByte(mask);
+            p += 8;
+        }
+        while (p < end && static_cast<unsigned char>(*p) <= 0x20) p++;
+        return p;
+    }
+
+    // Copy the rest of a string whose opening quote was already written,
+    // returning the byte after its closing quote
+    const char* copyString(const char* p, const char* end, Output& out) {
+        for (;;) {
+            p = copyRun<StringStop>(p, end, out);
+            if (p >= end) {
+                return end;
+            }
+            if (*p == '"') {
+                out.put('"');
+                return p + 1;
+            }
+            // Escape: the next byte is copied whatever it is (it may be a quote)
+            const size_t size = std::min<size_t>(2, static_cast<size_t>(end - p));
+            out.put(p, size);
+            p += size;
+        }
+    }
+
+    // Whitespace before a value: dropped, except a newline separating
+    // top-level values, which is kept as one '\n'
+    struct Layout {
+        size_t depth = 0;
+        bool emitted = false;
+        bool pending_newline = false;
+
+        inline const char* skip(const char* p, const char* end) {
+            if (depth > 0) {
+                return skipSpace(p, end);
+            }
+            while (p < end && static_cast<unsigned char>(*p) <= 0x20) {
+                if (*p == '\n' && emitted) pending_newline = true;
+                p++;
+            }
+            return p;
+        }
+
+        inline void beginValue(Output& out) {
+            if (pending_newline) {
+                out.put('\n');
+                pending_newline = false;
+            }
+            emitted = true;
+        }
+    };
+
+
+    // One bit per byte of a 64 byte block (bit i: byte i)
+    struct BlockMasks {
+        uint64_t quote;
+        uint64_t backslash;
+        uint64_t space;     // <= 0x20: whitespace, and control bytes never valid outside strings
+        uint64_t newline;
+    };
+
+#if defined(__SSE2__)
+    inline BlockMasks classify(const char* block) {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i space = _mm_set1_epi8(0x20);
+        const __m128i newline = _mm_set1_epi8('\n');
+        BlockMasks masks{0, 0, 0, 0};
+        for (int i = 0; i < 4; i++) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+            const int shift = 16 * i;
+            masks.quote |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << shift;
+            masks.backslash |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)))) << shift;
+            masks.space |= static_cast<uint64_t>(static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, space), space)))) << shift;
+            masks.newline |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)))) << shift;
+        }
+        return masks;
+    }
+#else
+    // High bits of a SWAR mask gathered into the low 8 bits (byte i -> bit i)
+    inline uint64_t gatherBits(uint64_t mask) {
+        return ((mask >> 7) * 0x0102040810204080ULL) >> 56;
+    }
+
+    inline BlockMasks classify(const char* block) {
+        BlockMasks masks{0, 0, 0, 0};
+        for (int i = 0; i < 8; i++) {
+            uint64_t word = load64(block + 8 * i);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            word = __builtin_bswap64(word);
+#endif
+            const int shift = 8 * i;
+            masks.quote |= gatherBits(equalBytes(word, '"')) << shift;
+            masks.backslash |= gatherBits(equalBytes(word, '\\')) << shift;
+            masks.space |= gatherBits(belowBytes(word, 0x21)) << shift;
+            masks.newline |= gatherBits(equalBytes(word, '\n')) << shift;
+        }
+        return masks;
+    }
+#endif
+
+    inline uint64_t prefixXor(uint64_t bits) {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    // Counts 0 for an empty mask, unlike the builtins
+    inline int trailingZeros(uint64_t bits) {
+        return bits ? __builtin_ctzll(bits) : 64;
+    }
+
+    // Minify state carried from one block to the next
+    class Minifier {
+    public:
+        explicit Minifier(char* out) : out_(out), pos_(out) {}
+
+        // `valid`: bytes of the block that belong to the input (all but in the tail).
+        // `speculative`: the output has room for a 16 byte store at any kept byte,
+        // which holds for every block but the last since the output never outgrows the input.
+        void block(const char* data, uint64_t valid, bool speculative) {
+            const BlockMasks masks = classify(data);
+
+            // Bytes escaped by a backslash; backslashes are rare, so one step per backslash
+            uint64_t escaped = escape_carry_;
+            uint64_t backslash = masks.backslash & ~escaped & valid;
+            escape_carry_ = 0;
+            while (backslash) {
+                const int i = __builtin_ctzll(backslash);
+                if (i == 63) {
+                    escape_carry_ = 1;
+                    break;
+                }
+                escaped |= 2ULL << i;
+                backslash &= ~(3ULL << i);
+            }
+
+            // Bytes inside strings, opening quote included, closing quote excluded
+            const uint64_t strings = prefixXor(masks.quote & ~escaped) ^ in_string_;
+            in_string_ = static_cast<uint64_t>(0) - (strings >> 63);
+
+            const uint64_t drop = (masks.space & ~strings) | ~valid;
+            if (drop == 0 && !pending_newline_) {
+                std::memcpy(pos_, data, 64);
+                pos_ += 64;
+                return;
+            }
+            const uint64_t newlines = masks.newline & drop & valid;
+
+            // Kept runs are copied one at a time; the gaps between them are dropped
+            uint64_t keep = ~drop;
+            int gap_start = 0;
+            while (keep) {
+                const int start = __builtin_ctzll(keep);
+                const int length = trailingZeros(~(keep >> start));
+                const uint64_t gap = start == 0 ? 0 : (~0ULL >> (64 - start)) & (~0ULL << gap_start);
+                if (newlines & gap) {
+                    pending_newline_ = true;
+                }
+                if (pending_newline_) {
+                    separate(data[start]);
+                }
+                if (speculative && length <= 16) {
+                    std::memcpy(pos_, data + start, 16);
+                } else {
+                    std::memcpy(pos_, data + start, static_cast<size_t>(length));
+                }
+                pos_ += length;
+                gap_start = start + length;
+                keep = gap_start >= 64 ? 0 : keep & (~0ULL << gap_start);
+            }
+            if (gap_start < 64 && (newlines >> gap_start)) {
+                pending_newline_ = true;
+            }
+        }
+
+        inline size_t size() const { return static_cast<size_t>(pos_ - out_); }
+
+    private:
+        // A dropped newline is kept, once, between two values with no separator:
+        // in valid JSON that only happens between top-level values (NDJSON)
+        inline void separate(char next) {
+            pending_newline_ = false;
+            if (pos_ == out_) return;
+            const char previous = pos_[-1];
+            if (previous == ',' || previous == ':' || previous == '[' || previous == '{') return;
+            if (next == ',' || next == ':' || next == ']' || next == '}') return;
+            *pos_++ = '\n';
+        }
+
+        char* out_;
+        char* pos_;
+        uint64_t in_string_ = 0;
+        uint64_t escape_carry_ = 0;
+        bool pending_newline_ = false;
+    };
+
+} // namespace
+
+size_t minify(std::string_view json, char* out) {
+    Minifier minifier(out);
+    const char* p = json.data();
+    const char* end = p + json.size();
+    while (end - p >= 64) {
+        // The last full block may not store past the end of the output
+        minifier.block(p, ~0ULL, end - p >= 80);
+        p += 64;
+    }
+    if (p < end) {
+        const size_t tail = static_cast<size_t>(end - p);
+        char block[64];
+        std::memcpy(block, p, tail);
+        std::memset(block + tail, ' ', sizeof(block) - tail);
+        minifier.block(block, ~0ULL >> (64 - tail), false);
+    }
+    return minifier.size();
+}
+
+std::string minify(std::string_view json) {
+    std::string result(json.size(), '\0');
+    result.resize(minify(json, result.data()));
+    return result;
+}
+
+size_t prettify(std::string_view json, char* out, size_t capacity, unsigned indent) {
+    Output output(out, capacity);
+    Layout layout;
+    const char* p = json.data();
+    const char* end = p + json.size();
+    while ((p = layout.skip(p, end)) < end) {
+        layout.beginValue(output);
+        const char c = *p;
+        switch (c) {
+            case '"':
+                output.put('"');
+                p = copyString(p + 1, end, output);
+                break;
+            case '{':
+            case '[': {
+                output.put(c);
+                p = skipSpace(p + 1, end);
+                const char close = c == '{' ? '}' : ']';
+                if (p < end && *p == close) {
+                    output.put(close);
+                    p++;
+                } else {
+                    layout.depth++;
+                    output.newline(layout.depth * indent);
+                }
+                break;
+            }
+            case '}':
+            case ']':
+                if (layout.depth > 0) layout.depth--;
+                output.newline(layout.depth * indent);
+                output.put(c);
+                p++;
+                break;
+            case ',':
+                output.put(',');
+                output.newline(layout.depth * indent);
+                p++;
+                break;
+            case ':':
+                output.put(':');
+                output.put(' ');
+                p++;
+                break;
+            default:
+                p = copyRun<ScalarStop>(p, end, output);
+                break;
+        }
+    }
+    return output.total();
+}
+
+std::string prettify(std::string_view json, unsigned indent) {
+    std::string result(json.size() + json.size() / 2 + 64, '\0');
+    size_t size = prettify(json, result.data(), result.size(), indent);
+    if (size > result.size()) {
+        result.resize(size);
+        size = prettify(json, result.data(), result.size(), indent);
+    }
+    result.resize(size);
+    return result;
+}
+
+} // namespace lazyjson
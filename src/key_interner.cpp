@@ -0,0 +1,117 @@
+#include "key_interner.hpp"
+#include "hash.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace lazyjson {
+
+namespace {
+    constexpr size_t kKeyBlockSize = 64 * 1024;
+}
+
+KeyInterner::KeyInterner(size_t max_keys) : max_keys_(max_keys) {
+    // Load factor of at most 1/2 keeps probe sequences short
+    size_t slots = 16;
+    while (slots < max_keys_ * 2) {
+        slots <<= 1;
+    }
+    mask_ = slots - 1;
+    slots_.reset(new std::atomic<const Entry*>[slots]);
+    for (size_t i = 0; i < slots; i++) {
+        slots_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    by_id_.reset(new std::atomic<const Entry*>[max_keys_]);
+    for (size_t i = 0; i < max_keys_; i++) {
+        by_id_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+KeyInterner::~KeyInterner() {
+    for (char* block : blocks_) {
+        std::free(block);
+    }
+}
+
+const KeyInterner::Entry* KeyInterner::lookup(std::string_view key, uint64_t hash, size_t& slot) const {
+    slot = static_cast<size_t>(hashMix(hash)) & mask_;
+    while (true) {
+        const Entry* entry = slots_[slot].load(std::memory_order_acquire);
+        if (!entry) {
+            return nullptr;
+        }
+        if (entry->hash == hash && entry->length == key.size()
+            && std::memcmp(entry->data, key.data(), key.size()) == 0) {
+            return entry;
+        }
+        slot = (slot + 1) & mask_;
+    }
+}
+
+KeyId KeyInterner::find(std::string_view key, uint64_t hash) const {
+    size_t slot;
+    const Entry* entry = lookup(key, hash, slot);
+    return entry ? entry->id : kNoKeyId;
+}
+
+KeyId KeyInterner::find(std::string_view key) const {
+    return find(key, hashKey(key));
+}
+
+KeyId KeyInterner::intern(std::string_view key) {
+    return intern(key, hashKey(key));
+}
+
+KeyId KeyInterner::intern(std::string_view key, uint64_t hash) {
+    size_t slot;
+    if (const Entry* entry = lookup(key, hash, slot)) {
+        return entry->id;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Another thread may have added the key (or a colliding one) meanwhile
+    if (const Entry* entry = lookup(key, hash, slot)) {
+        return entry->id;
+    }
+    const size_t id = size_.load(std::memory_order_relaxed);
+    if (id >= max_keys_ || key.size() > UINT32_MAX) {
+        return kNoKeyId;
+    }
+
+    entries_.push_back(Entry{hash, store(key), static_cast<uint32_t>(key.size()), static_cast<KeyId>(id)});
+    const Entry* entry = &entries_.back();
+    // Publish the entry: readers only see it fully initialized
+    by_id_[id].store(entry, std::memory_order_release);
+    slots_[slot].store(entry, std::memory_order_release);
+    size_.store(id + 1, std::memory_order_release);
+    return entry->id;
+}
+
+std::string_view KeyInterner::key(KeyId id) const {
+    if (id >= max_keys_) {
+        return {};
+    }
+    const Entry* entry = by_id_[id].load(std::memory_order_acquire);
+    return entry ? std::string_view(entry->data, entry->length) : std::string_view{};
+}
+
+const char* KeyInterner::store(std::string_view key) {
+    if (key.empty()) {
+        return "";
+    }
+    if (blocks_.empty() || block_used_ + key.size() > block_size_) {
+        block_size_ = key.size() > kKeyBlockSize ? key.size() : kKeyBlockSize;
+        char* block = static_cast<char*>(std::malloc(block_size_));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        blocks_.push_back(block);
+        block_used_ = 0;
+    }
+    char* data = blocks_.back() + block_used_;
+    std::memcpy(data, key.data(), key.size());
+    block_used_ += key.size();
+    return data;
+}
+
+} // namespace lazyjson
@@ -0,0 +1,81 @@
+#include "large_document.hpp"
+#include <algorithm>
+#include <cstdint>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace lazyjson {
+
+namespace {
+
+    constexpr size_t kSampleBytes = 1024 * 1024;
+
+    // Tokens in a window: every structural character, plus every scalar (a run
+    // of other characters, or a string, following a structural character)
+    uint64_t countTokens(std::string_view window, bool in_string) {
+        uint64_t tokens = 0;
+        bool after_structural = true;
+        bool escaped = false;
+        for (char c : window) {
+            if (in_string) {
+                if (escaped) escaped = false;
+                else if (c == '\\') escaped = true;
+                else if (c == '"') in_string = false;
+                continue;
+            }
+            switch (c) {
+                case '{': case '}': case '[': case ']': case ',': case ':':
+                    tokens++;
+                    after_structural = true;
+                    break;
+                case ' ': case '\t': case '\n': case '\r':
+                    break;
+                default:
+                    tokens += after_structural;
+                    after_structural = false;
+                    in_string = c == '"';
+                    break;
+            }
+        }
+        return tokens;
+    }
+
+    // A window may start inside a string: count it both ways and keep the larger
+    // count (the wrong guess skips the structure, which is the denser part)
+    uint64_t countTokens(std::string_view window) {
+        return std::max(countTokens(window, false), countTokens(window, true));
+    }
+
+} // namespace
+
+size_t estimateTokenCount(std::string_view source) {
+    if (source.size() <= 3 * kSampleBytes) {
+        const uint64_t tokens = countTokens(source);
+        return static_cast<size_t>(tokens + tokens / 8 + 16);
+    }
+    uint64_t sampled = 0;
+    for (size_t start : {size_t(0), (source.size() - kSampleBytes) / 2, source.size() - kSampleBytes}) {
+        sampled += countTokens(source.substr(start, kSampleBytes));
+    }
+    const double density = static_cast<double>(sampled) / static_cast<double>(3 * kSampleBytes);
+    // 1/8 of margin: one reservation should cover the document, and pages never
+    // touched cost address space only
+    return static_cast<size_t>(density * static_cast<double>(source.size()) * 1.125) + 16;
+}
+
+void adviseHugePages(const void* data, size_t size) {
+#ifdef MADV_HUGEPAGE
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + page - 1) & ~(page - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(data) + size) & ~(page - 1);
+    if (data && end > begin) {
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+    }
+#else
+    (void)data;
+    (void)size;
+#endif
+}
+
+} // namespace lazyjson
@@ -1,26 +1,102 @@
 #include "parser.hpp"
-#include <iostream>
+#include "tape_util.hpp"
+#include "value_view.hpp"
 #include <sstream>
 #include <stdexcept>
 #include <cstdio>
+#include <cstdlib>
 #include <string>
 #include <chrono>
+#include <charconv>
 using namespace std::chrono;
 
 namespace lazyjson {
 
+namespace {
+
+    inline ErrorKind errorKind(TokenizerError error) {
+        return error == TokenizerError::UNTERMINATED_STRING ? ErrorKind::UNTERMINATED_STRING : ErrorKind::UNEXPECTED_CHARACTER;
+    }
+
+    // Next component of a path expression ("a.b[2].c"), without allocating.
+    // Returns false at the end of the path or on an unterminated '['.
+    bool nextComponent(std::string_view path, size_t& pos, std::string_view& component, bool& invalid) {
+        while (pos < path.size() && path[pos] == '.') {
+            pos++;
+        }
+        if (pos >= path.size()) {
+            return false;
+        }
+        if (path[pos] == '[') {
+            const size_t close = path.find(']', pos);
+            if (close == std::string_view::npos) {
+                invalid = true;
+                return false;
+            }
+            component = path.substr(pos + 1, close - pos - 1);
+            pos = close + 1;
+            return true;
+        }
+        const size_t end = path.find_first_of(".[", pos);
+        component = path.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        pos = end == std::string_view::npos ? path.size() : end;
+        return true;
+    }
+
+} // namespace
+
 // Parser implementation
 Parser::Parser() : string_buffer_(4096) {
     tokenizer_ = Tokenizer();
 }
 
+bool Parser::statsEnabled() {
+#ifdef LAZYJSON_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Parser::updateMemoryStats() const {
+    stats_.string_buffer_bytes = string_buffer_.used();
+    stats_.string_buffer_capacity = string_buffer_.capacity();
+    stats_.string_buffer_blocks = string_buffer_.block_count();
+    stats_.string_buffer_wasted = string_buffer_.wasted();
+    stats_.memory_bytes = tokens_.capacity() * sizeof(Token)
+                        + string_buffer_.capacity()
+                        + (stats_.nodes_materialized + 1) * sizeof(DataElement);
+    if (stats_.memory_bytes > stats_.peak_memory_bytes) {
+        stats_.peak_memory_bytes = stats_.memory_bytes;
+    }
+}
+
+int Parser::fail(ErrorKind kind, size_t token_index) const {
+    error_.kind = kind;
+    error_.offset = 0;
+    if (!tokens_.empty()) {
+        // <SOF> points at the start of the source; string tokens start after their quote
+        const Token& token = tokens_[std::min(token_index, tokens_.size() - 1)];
+        error_.offset = static_cast<size_t>(token.value.data() - tokens_.front().value.data())
+                      - (token.type == TokenType::TOKEN_STRING ? 1 : 0);
+    }
+    return 1;
+}
+
 // Helper function to skip a value during lazy parsing
-void Parser::skipValue(const std::vector<Token>& tokens, size_t& currentIndex) {
+int Parser::skipValue(const std::vector<Token>& tokens, size_t& currentIndex) const {
     if (currentIndex >= tokens.size()) {
-        throw std::runtime_error("Unexpected end of tokens");
+        return fail(ErrorKind::UNEXPECTED_END, currentIndex);
     }
     
     const Token& token = tokens[currentIndex++];
+
+    // Tokens loaded from a sidecar know where each container ends
+    if (!token_jumps_.empty()
+        && (token.type == TokenType::TOKEN_OBJECT_START || token.type == TokenType::TOKEN_ARRAY_START)) {
+        currentIndex = token_jumps_[currentIndex - 1] + 1;
+        return 0;
+    }
     
     switch (token.type) {
         case TokenType::TOKEN_OBJECT_START: {
@@ -53,43 +129,196 @@ void Parser::skipValue(const std::vector<Token>& tokens, size_t& currentIndex) {
         case TokenType::TOKEN_NULL:
             // Already consumed by currentIndex++
             break;
+        case TokenType::TOKEN_EOF:
+            // The input ends where a value was expected
+            return fail(ErrorKind::UNEXPECTED_END, currentIndex - 1);
         default:
-            throw std::runtime_error("Unexpected token type");
+            return fail(ErrorKind::UNEXPECTED_TOKEN, currentIndex - 1);
+    }
+    return 0;
+}
+
+size_t Parser::valueEnd(size_t token_index) const {
+    return tape_detail::valueEnd(tokens_, token_jumps_, token_index);
+}
+
+void Parser::buildTokenJumps() {
+    if (token_jumps_.size() != tokens_.size()) {
+        computeJumps(tokens_, token_jumps_);
+    }
+}
+
+void Parser::reset() {
+    error_ = Error{};
+    tokens_.clear();
+    token_jumps_.clear();
+    source_file_.reset();
+    stream_.clear();
+    string_buffer_.clear();
+    // Elements handed out by get() may still be referenced: only recycle an unshared root
+    if (root_.use_count() == 1) {
+        root_->clear();
+    } else {
+        root_ = makeElement();
+    }
+}
+
+bool Parser::feed(std::string_view chunk) {
+    // The first chunk starts a new document
+    if (!stream_.started() || stream_.finished()) {
+        reset();
+    }
+    TokenizerError error = TokenizerError::NONE;
+    LAZYJSON_STATS_TIMER(timer, stats_.tokenize_ns);
+    if (stream_.feed(chunk, error) != 0) {
+        error_ = Error{errorKind(error), stream_.errorOffset()};
+        stream_.clear();
+        return false;
+    }
+    return true;
+}
+
+bool Parser::finish() {
+    if (!stream_.started() || stream_.finished()) {
+        reset();
+    }
+    TokenizerError error = TokenizerError::NONE;
+    {
+        LAZYJSON_STATS_TIMER(timer, stats_.tokenize_ns);
+        if (stream_.finish(error) != 0) {
+            error_ = Error{errorKind(error), stream_.errorOffset()};
+            stream_.clear();
+            return false;
+        }
+        // The tape was built while the input arrived: only views and jumps are left to set
+        stream_.takeTokens(tokens_, token_jumps_);
     }
+    LAZYJSON_STATS(
+        stats_.bytes_scanned += stream_.buffer().size();
+        for (const auto& token : tokens_) {
+            stats_.tokens_by_type[static_cast<size_t>(token.type)]++;
+        }
+    );
+    return parseTokens();
 }
 
-bool Parser::parse(std::string& jsonString) {
+size_t Parser::retainedBytes() const {
+    return sizeof(Parser)
+         + tokens_.capacity() * sizeof(Token)
+         + token_jumps_.capacity() * sizeof(size_t)
+         + tokenizer_.capacity() * sizeof(Token)
+         + shape_keys_.capacity() * sizeof(std::string_view)
+         + stream_.buffer().capacity()
+         + string_buffer_.capacity();
+}
+
+bool Parser::parse(std::string_view jsonString) {
 
+    reset();
     TokenizerError error = TokenizerError::NONE;
+    {
+        LAZYJSON_STATS_TIMER(timer, stats_.tokenize_ns);
         if (tokenizer_.tokenize(jsonString, error) != 0) {
-        std::cerr << "Tokenization error: " << static_cast<int>(error) << std::endl;
+            error_ = Error{errorKind(error), tokenizer_.errorOffset()};
+            return false;
+        }
+        //std::cout << "TOKENS : \n" << tokenizer_.toString() << std::endl;
+        tokenizer_.swapTokens(tokens_);
+    }
+    LAZYJSON_STATS(
+        stats_.bytes_scanned += jsonString.size();
+        for (const auto& token : tokens_) {
+            stats_.tokens_by_type[static_cast<size_t>(token.type)]++;
+        }
+    );
+
+    return parseTokens();
+}
+
+bool Parser::load(const std::string& json_path, const std::string& tape_path, TapeValidation validation) {
+    reset();
+    auto source_file = std::make_shared<MappedFile>();
+    TapeError tape_error = TapeError::NONE;
+    if (source_file->open(json_path, tape_error) != 0) {
+        error_ = Error{ErrorKind::IO_ERROR, 0};
         return false;
     }
-    //std::cout << "TOKENS : \n" << tokenizer_.toString() << std::endl;
-    tokens_ = tokenizer_.getTokens();
+    const std::string_view source = source_file->view();
+
+    if (readTape(tape_path, source, validation, tokens_, token_jumps_, tape_error) != 0) {
+        // Missing, stale or corrupted sidecar: tokenize and refresh it for the next run
+        TokenizerError error = TokenizerError::NONE;
+        {
+            LAZYJSON_STATS_TIMER(timer, stats_.tokenize_ns);
+            if (tokenizer_.tokenize(source, error) != 0) {
+                error_ = Error{errorKind(error), tokenizer_.errorOffset()};
+                return false;
+            }
+            tokenizer_.swapTokens(tokens_);
+        }
+        computeJumps(tokens_, token_jumps_);
+        // Best effort: without a sidecar the next load() tokenizes again
+        writeTape(tape_path, source, tokens_, token_jumps_, tape_error);
+    }
+    LAZYJSON_STATS(
+        stats_.bytes_scanned += source.size();
+        for (const auto& token : tokens_) {
+            stats_.tokens_by_type[static_cast<size_t>(token.type)]++;
+        }
+    );
+    source_file_ = std::move(source_file);
+    return parseTokens();
+}
+
+bool Parser::saveTape(const std::string& tape_path) const {
+    if (tokens_.size() < 2) {
+        return false;
+    }
+    // <SOF> and <EOF> delimit the whole source
+    const char* begin = tokens_.front().value.data();
+    const std::string_view source(begin, static_cast<size_t>(tokens_.back().value.data() - begin));
+    std::vector<size_t> jumps;
+    const std::vector<size_t>* jumps_ptr = &token_jumps_;
+    if (token_jumps_.size() != tokens_.size()) {
+        computeJumps(tokens_, jumps);
+        jumps_ptr = &jumps;
+    }
+    TapeError error = TapeError::NONE;
+    return writeTape(tape_path, source, tokens_, *jumps_ptr, error) == 0;
+}
 
+bool Parser::parseTokens() {
     // Parse the root value
-    try {
+    LAZYJSON_STATS_TIMER(timer, stats_.parse_ns);
+    {
         size_t currentIndex = 1;  // Skipping <SOF> START_OF_FILE
         
-        auto err = parseElement(root_, currentIndex);
+        if (parseElement(root_, currentIndex) != 0) {
+            return false;
+        }
         const size_t lastValidTokenIndex = tokens_.size()-2;
         const auto lastValidToken = tokens_[tokens_.size()-2];
+        const bool scalarRoot = root_->getType() != ElementType::OBJECT && root_->getType() != ElementType::ARRAY;
         if(
             (root_->getType() == ElementType::OBJECT && lastValidToken.type == TokenType::TOKEN_OBJECT_END) ||
             (root_->getType() == ElementType::ARRAY && lastValidToken.type == TokenType::TOKEN_ARRAY_END)
         ){
             root_->setTokenEndIndex(lastValidTokenIndex);
+        } else if (scalarRoot && lastValidTokenIndex == 1) {
+            // A single scalar is a valid document too (e.g. a record of a top-level array)
+            root_->setTokenEndIndex(lastValidTokenIndex);
         } else {
-            throw std::runtime_error("Expected '}' or ']' as last valid token");
+            // Expected '}' or ']' as last valid token
+            fail(ErrorKind::UNEXPECTED_TOKEN, lastValidTokenIndex);
+            return false;
         }
 
-        materializeElement(*root_);
+        if (materializeElement(*root_) != 0) {
+            return false;
+        }
+        LAZYJSON_STATS(updateMemoryStats());
 
         return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Parse error: " << e.what() << std::endl;
-        return false;
     }
 }
 
@@ -97,7 +326,7 @@ int Parser::materializeElement(DataElement& element) {
     if(element.isMaterialized()) return 0;
     
     if (element.getTokenIndexStart() >= tokens_.size()) {
-        throw std::runtime_error("Unexpected end of tokens");
+        return fail(ErrorKind::UNEXPECTED_END, element.getTokenIndexStart());
     }
     
     const auto& token_value = tokens_[element.getTokenIndexStart()].value;
@@ -106,23 +335,36 @@ int Parser::materializeElement(DataElement& element) {
         case ElementType::OBJECT:
         case ElementType::ARRAY:
             {
-
-                for(const auto& [token_name, token_index] : element.getTokenIndexList()){
-                    if(token_index >= tokens_.size())
-                        throw std::runtime_error("Out of range");
-                    std::shared_ptr<DataElement> object = std::make_shared<DataElement>();
+                int err = 0;
+                element.forEachTokenIndex([&](std::string_view token_name, size_t token_index){
+                    if (err) return;
+                    if (token_index >= tokens_.size()) {
+                        err = fail(ErrorKind::UNEXPECTED_END, token_index);
+                        return;
+                    }
+                    ElementPtr object = makeElement();
+                    LAZYJSON_STATS(stats_.nodes_materialized++);
                     // Parsing all the token in the list
                     auto currentIndex = token_index;
-                    parseElement(object, currentIndex);
-                    element.addMaterializedElement(token_name, object);
-                }
+                    err = parseElement(object, currentIndex);
+                    if (!err) element.addMaterializedElement(token_name, object);
+                });
+                if (err) return err;
             }
             break;
         case ElementType::STRING:
             element.setMaterializedValue(token_value);
             break;
         case ElementType::NUMBER:
-            element.setMaterializedValue(std::stod(std::string(token_value)));
+            {
+                double value = 0;
+                auto result = std::from_chars(token_value.data(), token_value.data() + token_value.size(), value);
+                if (result.ec != std::errc() || result.ptr != token_value.data() + token_value.size()) {
+                    // Out of range or unusual notation: strtod saturates instead of failing
+                    value = std::strtod(std::string(token_value).c_str(), nullptr);
+                }
+                element.setMaterializedValue(value);
+            }
             break;
         case ElementType::BOOLEAN:
             element.setMaterializedValue((token_value == "true" ? true : false));
@@ -131,17 +373,17 @@ int Parser::materializeElement(DataElement& element) {
             element.setMaterializedValue(DataNull{});
             break;
         default:
-            throw std::runtime_error("Unexpected token type");
+            return fail(ErrorKind::UNEXPECTED_TOKEN, element.getTokenIndexStart());
     }
     element.setIsMaterialized(true);
     return 0;
 }
 
 
-int Parser::parseElement(std::shared_ptr<DataElement> element, size_t& currentIndex){
+int Parser::parseElement(ElementPtr element, size_t& currentIndex){
     // Check 
     if (currentIndex >= tokens_.size()) {
-        throw std::runtime_error("Out of index");
+        return fail(ErrorKind::UNEXPECTED_END, currentIndex);
     }
 
     element->setTokenStartIndex(currentIndex);
@@ -163,6 +405,10 @@ int Parser::parseElement(std::shared_ptr<DataElement> element, size_t& currentIn
             {
                 element->setType(ElementType::OBJECT);
                 currentIndex++; // Skip '{'
+                // With a shape cache the keys are collected first and registered as a whole
+                std::vector<size_t> slot_token_index;
+                bool shaping = shape_cache_ != nullptr;
+                if (shaping) shape_keys_.clear();
                 int depth = 1;
                 while (depth > 0 && currentIndex < tokens_.size()) {
                     auto token_type = tokens_[currentIndex].type;
@@ -170,19 +416,48 @@ int Parser::parseElement(std::shared_ptr<DataElement> element, size_t& currentIn
                         case TokenType::TOKEN_OBJECT_START: depth++; break;
                         case TokenType::TOKEN_OBJECT_END: depth--; break;
                         case TokenType::TOKEN_COMMA: currentIndex++; break;
+                        case TokenType::TOKEN_EOF: return fail(ErrorKind::UNEXPECTED_END, currentIndex);
                     }
                     if(depth <= 0) break; // Stop in case the object ends '}'
                     std::string_view token_key = tokens_[currentIndex].value;
                     currentIndex++; // Consume key
                     if (currentIndex >= tokens_.size() || tokens_[currentIndex].type != TokenType::TOKEN_COLON) {
-                        throw std::runtime_error("Expected ':' after object key");
+                        // Expected ':' after object key
+                        return fail(ErrorKind::UNEXPECTED_TOKEN, currentIndex);
                     }
                     currentIndex++; // Consume ':'
-                    element->addTokenIndex(token_key, currentIndex);
+                    if (shaping && shape_keys_.size() == shape_cache_->maxKeys()) {
+                        // Too wide to be shaped: register what was collected so far
+                        shaping = false;
+                        for (size_t i = 0; i < shape_keys_.size(); i++) {
+                            element->addTokenIndex(shape_keys_[i], slot_token_index[i]);
+                        }
+                    }
+                    if (shaping) {
+                        shape_keys_.push_back(token_key);
+                        slot_token_index.push_back(currentIndex);
+                    } else {
+                        element->addTokenIndex(token_key, currentIndex);
+                    }
+                    LAZYJSON_STATS(stats_.nodes_registered++);
                     // Skip value for lazy parsing
-                    skipValue(tokens_, currentIndex);
+                    if (skipValue(tokens_, currentIndex) != 0) {
+                        return 1;
+                    }
                 }
                 element->setTokenEndIndex(currentIndex);
+                if (shaping && !shape_keys_.empty()) {
+                    auto shape = shape_cache_->intern(shape_keys_, ShapeCache::hashKeys(shape_keys_));
+                    if (shape) {
+                        LAZYJSON_STATS(stats_.shaped_objects++);
+                        element->setShape(std::move(shape), std::move(slot_token_index));
+                    } else {
+                        // Not shapeable (duplicate keys, cache full...): per-object map
+                        for (size_t i = 0; i < shape_keys_.size(); i++) {
+                            element->addTokenIndex(shape_keys_[i], slot_token_index[i]);
+                        }
+                    }
+                }
             }
             break;
         case TokenType::TOKEN_ARRAY_START:
@@ -193,28 +468,36 @@ int Parser::parseElement(std::shared_ptr<DataElement> element, size_t& currentIn
                 int depth = 1;
                 while (depth > 0 && currentIndex < tokens_.size()) {
                     auto token_type = tokens_[currentIndex].type;
+                    // Nested arrays are consumed whole by skipValue, so a '[' here
+                    // is the start of an element and must not change the depth
                     switch(token_type){
-                        case TokenType::TOKEN_ARRAY_START: depth++; break;
                         case TokenType::TOKEN_ARRAY_END: depth--; break;
                         case TokenType::TOKEN_COMMA: currentIndex++; break;
+                        case TokenType::TOKEN_EOF: return fail(ErrorKind::UNEXPECTED_END, currentIndex);
+                        default: break; // The first token of an element
                     }
                     if(depth <= 0) break; // Stop in case the object ends ']'
-                    std::string_view token_key = tokens_[currentIndex].value;
-                    auto stableStringView = string_buffer_.add(std::to_string(array_index++));
+                    char index_text[20];
+                    auto index_end = std::to_chars(index_text, index_text + sizeof(index_text), array_index++).ptr;
+                    auto stableStringView = string_buffer_.add(std::string_view(index_text, static_cast<size_t>(index_end - index_text)));
                     element->addTokenIndex(stableStringView, currentIndex);
+                    LAZYJSON_STATS(stats_.nodes_registered++);
                     // Skip value for lazy parsing
-                    skipValue(tokens_, currentIndex);
+                    if (skipValue(tokens_, currentIndex) != 0) {
+                        return 1;
+                    }
                 }
                 element->setTokenEndIndex(currentIndex);
             }
             break;
         default:
-            throw std::runtime_error("Expected a value or '{' or '['");
+            // Expected a value or '{' or '['
+            return fail(ErrorKind::UNEXPECTED_TOKEN, currentIndex);
     }
     return 0;
 }
 
-int Parser::set(const std::string& path, const std::shared_ptr<DataElement> element) {
+int Parser::set(const std::string& path, const ElementPtr element) {
     /*
     const auto& pathComponents = splitPath(path);
     auto currentElement = root_;
@@ -230,7 +513,7 @@ int Parser::set(const std::string& path, const std::shared_ptr<DataElement> elem
                 DataElementManager::safeDestroy(currentElement);
                 std::cout << "[set] Adding element to previous element (TBD!)" << std::endl;
                 previousElement->addMaterializedElement(component, element);
-                auto stableStringView = string_buffer_.add(std::string(component));
+                auto stableStringView = string_buffer_.add(component);
                 previousElement->addTokenIndex(stableStringView, 0);
                 break;
             case ElementType::OBJECT:
@@ -241,7 +524,7 @@ int Parser::set(const std::string& path, const std::shared_ptr<DataElement> elem
                     std::cout << "[set] Destroying the element of the object/array" << std::endl;
                     DataElementManager::safeDestroy(currentElement);
                     previousElement->addMaterializedElement(component, element);
-                    auto stableStringView = string_buffer_.add(std::string(component));
+                    auto stableStringView = string_buffer_.add(component);
                     previousElement->addTokenIndex(stableStringView, 0);
                     return 0;
                 }
@@ -250,7 +533,7 @@ int Parser::set(const std::string& path, const std::shared_ptr<DataElement> elem
                 if(!currentElement->get getElementKeyList(). (component)){
                     std::cout << "[set] Adding element to previous element" << std::endl;
                     currentElement->addMaterializedElement(component, element);
-                    auto stableStringView = string_buffer_.add(std::string(component));
+                    auto stableStringView = string_buffer_.add(component);
                     currentElement->addTokenIndex(stableStringView, 0);
                     return 0;
                 }
@@ -266,7 +549,7 @@ int Parser::set(const std::string& path, const std::shared_ptr<DataElement> elem
                         //std::cout << "[get] key/index exists in the object/array" << std::endl;
                         auto tokenIndex = currentElement->getTokenIndex(component);
                         const std::string_view tokenKey = currentElement->getTokenStringView(component);
-                        std::shared_ptr<DataElement> child = std::make_shared<DataElement>();
+                        ElementPtr child = makeElement();
                         auto err = parseElement(child, tokenIndex);
                         if(err){
                             std::string errMsg = "Parsing Element returned error: "; errMsg.append(std::to_string(err));
@@ -294,150 +577,185 @@ int Parser::set(const std::string& path, const std::shared_ptr<DataElement> elem
     return 0;
 }
 
-int Parser::get(const std::string& path, std::shared_ptr<DataElement>& element) {
-    
-    // Split path according to the standard format
-    const auto& pathComponents = splitPath(path);
-    /*
-    // Check if the DataElement has already been analyzed and cached into the radix tree
-    auto elementDirectPointer = radix_tree_.get(pathComponents);
-    if(elementDirectPointer) {
-        element = elementDirectPointer;
+int Parser::get(const std::string& path, ElementPtr& element) {
+    // Components are taken one at a time from the path, nothing is split up front
+    element = root_;
+    size_t pos = 0;
+    std::string_view component;
+    bool invalid = false;
+    while (nextComponent(path, pos, component, invalid)) {
+        if (element->getType() != ElementType::OBJECT && element->getType() != ElementType::ARRAY) {
+            break;
+        }
+        if (getChild(element, component, kNoKeyId, nullptr) != 0) {
+            return 1;
+        }
+    }
+    if (invalid) {
+        return fail(ErrorKind::INVALID_PATH, element->getTokenIndexStart());
+    }
+    if (!element->isMaterialized() && materializeElement(*element) != 0) {
+        return 1;
+    }
+    LAZYJSON_STATS(updateMemoryStats());
+    return 0;
+}
+
+int Parser::get(const Path& path, ElementPtr& element) {
+    // Components already split (at compile time for _jpath literals)
+    return getComponents(path.begin(), path.end(), path.interner() ? path.ids() : nullptr, path.interner(), element);
+}
+
+ElementPtr Parser::materializeChild(DataElement& parent, std::string_view tokenKey, size_t tokenIndex) {
+    LAZYJSON_STATS(stats_.path_cache_misses++);
+    LAZYJSON_STATS(stats_.nodes_materialized++);
+    LAZYJSON_STATS_TIMER(timer, stats_.materialize_ns);
+    ElementPtr child = makeElement();
+    if (parseElement(child, tokenIndex) != 0 || materializeElement(*child) != 0) {
+        return nullptr;
+    }
+    parent.addMaterializedElement(tokenKey, child);
+    return child;
+}
+
+int Parser::getChild(ElementPtr& element, std::string_view component, KeyId id, const KeyInterner* interner) {
+    // Keys of resolved paths are found in shaped objects by id
+    if (interner && element->getShape()) {
+        const size_t slot = element->getShape()->slotById(interner, id);
+        if (slot != Shape::kNoSlot) {
+            if (const auto* child = element->getMaterializedSlot(slot)) {
+                LAZYJSON_STATS(stats_.path_cache_hits++);
+                element = *child;
+            } else {
+                element = materializeChild(*element, element->getShape()->key(slot), element->getSlotTokenIndex(slot));
+            }
+            return element ? 0 : 1;
+        }
+    }
+    if (const auto* child = element->findMaterializedElement(component)) {
+        LAZYJSON_STATS(stats_.path_cache_hits++);
+        element = *child;
         return 0;
     }
-    */
+    size_t tokenIndex = 0;
+    if (!element->findTokenIndex(component, tokenIndex)) {
+        return fail(ErrorKind::KEY_NOT_FOUND, element->getTokenIndexStart());
+    }
+    element = materializeChild(*element, element->getTokenStringView(component), tokenIndex);
+    return element ? 0 : 1;
+}
 
+int Parser::getComponents(const std::string_view* first, const std::string_view* last, const KeyId* ids,
+                          const KeyInterner* interner, ElementPtr& element) {
     element = root_;  // Start from the root
-    /*
-    std::vector<std::string_view> shortcuts_list;
-
-    auto elementParentPointer = radix_tree_.find(pathComponents);
-    std::vector<std::string_view> shortPathComponents;
-    if(elementParentPointer.second) {
-        //std::cout << "Reassign" << std::endl;
-        shortPathComponents.assign(pathComponents.begin() + elementParentPointer.first.size(), pathComponents.end());
-        element = elementParentPointer.second;
-        shortcuts_list = elementParentPointer.first;
-    } else {
-        shortcuts_list.reserve(pathComponents.size());
+    for (const std::string_view* it = first; it != last; ++it) {
+        // A scalar ends the walk: it is returned materialized
+        if (element->getType() != ElementType::OBJECT && element->getType() != ElementType::ARRAY) {
+            break;
+        }
+        if (getChild(element, *it, ids ? ids[it - first] : kNoKeyId, ids ? interner : nullptr) != 0) {
+            return 1;
+        }
     }
-    */
-
-    //std::cout << "[get] Number of components: " << pathComponents.size() << std::endl;
-//    const std::vector<std::string_view>* selected = elementParentPointer.second ? &shortPathComponents : &pathComponents; 
-//    for (const auto& component : *selected) {
-//        shortcuts_list.emplace_back(component);
-    for (const auto& component : pathComponents) {
-        //std::cout << "[get] Analysing component: " << component << ", in type: " << element->getType() << std::endl;
-        switch (element->getType()) {
-            case ElementType::NULL_VALUE:
-            case ElementType::BOOLEAN:
-            case ElementType::NUMBER:
-            case ElementType::STRING:
-                if(!element->isMaterialized()) materializeElement(*element);
-                //std::cout << "[get] Found primitive type, returning materialized element" << std::endl;
-                return 0;
-            case ElementType::OBJECT:
-            case ElementType::ARRAY:
-                if (element->isMaterializedElement(component)) {
-                    //std::cout << "[get] get already materialized element" << std::endl;
-                    element = element->getMaterializedElement(component);
-                } else {
-                    if (element->isTokenIndexRegistered(component)) {
-                        //std::cout << "[get] key/index exists in the object/array" << std::endl;
-                        auto tokenIndex = element->getTokenIndex(component);
-                        const std::string_view tokenKey = element->getTokenStringView(component);
-                        std::shared_ptr<DataElement> child = std::make_shared<DataElement>();
-                        auto err = parseElement(child, tokenIndex);
-                        if(err){
-                            std::string errMsg = "Parsing Element returned error: "; errMsg.append(std::to_string(err));
-                            throw std::runtime_error(errMsg);
-                        }
-                        err = materializeElement(*child);
-                        if(err){
-                            std::string errMsg = "Materialize Element returned error: "; errMsg.append(std::to_string(err));
-                            throw std::runtime_error(errMsg);
-                        }
-                        element->addMaterializedElement(tokenKey, child);
-                        element = child;
-                    } else {
-                        std::string errMsg = "Key/index <";
-                        errMsg.append(component).append("> does not exist in the provided object/array");
-                        std::cerr << errMsg << std::endl;
-                        throw std::runtime_error(errMsg);
-                    }
-                }
-                break; 
-            default:
-                throw std::runtime_error("Unsupported type");
-        }   
-        //radix_tree_.insert(shortcuts_list, element);
+    // Children created while materializing their container are only parsed
+    if (!element->isMaterialized() && materializeElement(*element) != 0) {
+        return 1;
     }
+    LAZYJSON_STATS(updateMemoryStats());
     return 0;
 }
 
-std::vector<std::string_view> Parser::splitPath(const std::string& path) const {
-    std::vector<std::string_view> components;
-    
-    if (path.empty()) {
-        return components;
+Expected<ValueView> Parser::find(std::string_view path) noexcept {
+    if (tokens_.size() < 3) {
+        return Error{ErrorKind::UNEXPECTED_END, 0};
     }
-    
-    components.reserve(10);
-    
-    size_t start = 0;
+    // Raw pointers: children are owned by their parent, no reference count to touch
+    DataElement* element = root_.get();
+    size_t tokenIndex = root_->getTokenIndexStart();
     size_t pos = 0;
-    
-    while (pos < path.length()) {
-        if (path[pos] == '.') {
-            // Add component if not empty
-            if (pos > start) {
-                components.push_back(std::string_view(path.data() + start, pos - start));
-                //components.push_back(path.substr(start, pos - start));
-            }
-            start = pos + 1;
-        } else if (path[pos] == '[') {
-            // Add component before bracket if not empty
-            if (pos > start) {
-                components.push_back(std::string_view(path.data() + start, pos - start));
-//                components.push_back(path.substr(start, pos - start));
-            }
-            
-            // Find closing bracket
-            size_t closeBracket = path.find(']', pos);
-            if (closeBracket == std::string_view::npos) {
-                throw std::runtime_error("Unterminated '[' in path");
-            }
-            
-            // Extract index between brackets - manteniamo come string_view
-            components.push_back(std::string_view(path.data() + pos+1, closeBracket - pos - 1));
- //           components.push_back(path.substr(pos + 1, closeBracket - pos - 1));
-            
-            // Move past closing bracket
-            pos = closeBracket;
-            start = pos + 1;
+    std::string_view component;
+    bool invalid = false;
+    while (nextComponent(path, pos, component, invalid)) {
+        if (element->getType() != ElementType::OBJECT && element->getType() != ElementType::ARRAY) {
+            fail(ErrorKind::NOT_A_CONTAINER, tokenIndex);
+            return error_;
+        }
+        // A missing key costs this one lookup
+        if (!element->findTokenIndex(component, tokenIndex)) {
+            fail(ErrorKind::KEY_NOT_FOUND, element->getTokenIndexStart());
+            return error_;
+        }
+        // The last value is only viewed: no DataElement is created for it
+        size_t peek = pos;
+        std::string_view next;
+        if (!nextComponent(path, peek, next, invalid)) {
+            break;
+        }
+        if (const auto* child = element->findMaterializedElement(component)) {
+            LAZYJSON_STATS(stats_.path_cache_hits++);
+            element = child->get();
+        } else if (!(element = materializeChild(*element, element->getTokenStringView(component), tokenIndex).get())) {
+            return error_;
         }
-        
-        pos++;
     }
-    
-    // Add final component if not empty
-    if (start < path.length()) {
-        components.push_back(std::string_view(path.data() + start));
-//        components.push_back(path.substr(start));
+    if (invalid) {
+        fail(ErrorKind::INVALID_PATH, tokenIndex);
+        return error_;
     }
-    
-    return components;
+    return ValueView(*this, tokenIndex);
 }
 
+Expected<ValueView> Parser::find(const Path& path) noexcept {
+    if (tokens_.size() < 3) {
+        return Error{ErrorKind::UNEXPECTED_END, 0};
+    }
+    DataElement* element = root_.get();
+    size_t tokenIndex = root_->getTokenIndexStart();
+    const KeyInterner* interner = path.interner();
+    for (size_t i = 0; i < path.size(); i++) {
+        if (element->getType() != ElementType::OBJECT && element->getType() != ElementType::ARRAY) {
+            fail(ErrorKind::NOT_A_CONTAINER, tokenIndex);
+            return error_;
+        }
+        // Keys of resolved paths are found in shaped objects by id
+        size_t slot = Shape::kNoSlot;
+        if (interner && element->getShape()) {
+            slot = element->getShape()->slotById(interner, path.id(i));
+        }
+        if (slot != Shape::kNoSlot) {
+            tokenIndex = element->getSlotTokenIndex(slot);
+        } else if (!element->findTokenIndex(path.key(i), tokenIndex)) {
+            fail(ErrorKind::KEY_NOT_FOUND, element->getTokenIndexStart());
+            return error_;
+        }
+        // The last value is only viewed: no DataElement is created for it
+        if (i + 1 == path.size()) {
+            break;
+        }
+        const ElementPtr* child = slot != Shape::kNoSlot ? element->getMaterializedSlot(slot)
+                                                         : element->findMaterializedElement(path.key(i));
+        if (child) {
+            LAZYJSON_STATS(stats_.path_cache_hits++);
+            element = child->get();
+            continue;
+        }
+        const std::string_view key = slot != Shape::kNoSlot ? element->getShape()->key(slot)
+                                                            : element->getTokenStringView(path.key(i));
+        if (!(element = materializeChild(*element, key, tokenIndex).get())) {
+            return error_;
+        }
+    }
+    return ValueView(*this, tokenIndex);
+}
 
 std::string Parser::dump() const {
+    LAZYJSON_STATS_TIMER(timer, stats_.dump_ns);
     std::ostringstream oss;
     dumpElement(root_, oss, tokens_);
     return oss.str();
 }
 
-void Parser::dumpElement(const std::shared_ptr<lazyjson::DataElement> element, std::ostringstream& oss, const auto& tokens) const {
+void Parser::dumpElement(const ElementPtr element, std::ostringstream& oss, const auto& tokens) const {
     if(!element)
         throw std::runtime_error("Element points to null object");
     switch(element->getType()){
@@ -500,7 +818,8 @@ void Parser::dumpElement(const std::shared_ptr<lazyjson::DataElement> element, s
     }
 }
 
-std::string Parser::elementToString(std::shared_ptr<DataElement> element) const {
+std::string Parser::elementToString(ElementPtr element) const {
+    LAZYJSON_STATS_TIMER(timer, stats_.dump_ns);
     std::ostringstream oss;
     dumpElement(element, oss, tokens_);
     return oss.str();
@@ -0,0 +1,138 @@
+#include "parser_pool.hpp"
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+namespace lazyjson {
+
+struct ParserPool::State {
+    uint64_t id;
+    Options options;
+    mutable std::atomic<uint64_t> created{0};
+    // Cleared by ~ParserPool: thread caches of a dead pool are dropped
+    std::atomic<bool> alive{true};
+};
+
+namespace {
+
+    std::atomic<uint64_t> g_next_pool_id{1};
+
+    // Idle parsers of one pool in one thread
+    struct ThreadCache {
+        std::weak_ptr<const ParserPool::State> state;
+        std::vector<std::unique_ptr<Parser>> parsers;
+        size_t bytes = 0;
+    };
+
+    // Keyed by pool id rather than address, so a new pool never picks up the
+    // parsers of a destroyed one
+    std::unordered_map<uint64_t, ThreadCache>& threadCaches() {
+        thread_local std::unordered_map<uint64_t, ThreadCache> caches;
+        return caches;
+    }
+
+    ThreadCache* findThreadCache(uint64_t id) {
+        auto& caches = threadCaches();
+        auto it = caches.find(id);
+        return it == caches.end() ? nullptr : &it->second;
+    }
+
+    // Drop the caches of destroyed pools. The calling pool (`live_id`) is alive,
+    // so a thread using a single pool never locks anything here.
+    void sweepThreadCaches(uint64_t live_id) {
+        auto& caches = threadCaches();
+        if (caches.empty() || (caches.size() == 1 && caches.begin()->first == live_id)) {
+            return;
+        }
+        for (auto it = caches.begin(); it != caches.end();) {
+            auto state = it->first == live_id ? nullptr : it->second.state.lock();
+            if (it->first != live_id && (!state || !state->alive.load(std::memory_order_acquire))) {
+                it = caches.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+} // namespace
+
+ParserPool::ParserPool() : ParserPool(Options{}) {}
+
+ParserPool::ParserPool(Options options) : state_(std::make_shared<State>()) {
+    state_->id = g_next_pool_id.fetch_add(1, std::memory_order_relaxed);
+    state_->options = std::move(options);
+}
+
+ParserPool::~ParserPool() {
+    state_->alive.store(false, std::memory_order_release);
+    threadCaches().erase(state_->id);
+}
+
+ParserPool::Lease ParserPool::acquire() {
+    sweepThreadCaches(state_->id);
+    if (ThreadCache* cache = findThreadCache(state_->id)) {
+        if (!cache->parsers.empty()) {
+            std::unique_ptr<Parser> parser = std::move(cache->parsers.back());
+            cache->parsers.pop_back();
+            cache->bytes -= parser->retainedBytes();
+            return Lease(std::move(parser), state_);
+        }
+    }
+    state_->created.fetch_add(1, std::memory_order_relaxed);
+    auto parser = std::make_unique<Parser>();
+    parser->setShapeCache(state_->options.shape_cache);
+    return Lease(std::move(parser), state_);
+}
+
+size_t ParserPool::idleParsers() const {
+    const ThreadCache* cache = findThreadCache(state_->id);
+    return cache ? cache->parsers.size() : 0;
+}
+
+size_t ParserPool::idleBytes() const {
+    const ThreadCache* cache = findThreadCache(state_->id);
+    return cache ? cache->bytes : 0;
+}
+
+uint64_t ParserPool::created() const {
+    return state_->created.load(std::memory_order_relaxed);
+}
+
+ParserPool::Lease& ParserPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        parser_ = std::move(other.parser_);
+        state_ = std::move(other.state_);
+    }
+    return *this;
+}
+
+void ParserPool::Lease::release() {
+    if (!parser_) {
+        return;
+    }
+    std::unique_ptr<Parser> parser = std::move(parser_);
+    std::shared_ptr<const State> state = std::move(state_);
+    // Free the document now (elements, mapped file), keep the capacity
+    parser->reset();
+
+    if (!state->alive.load(std::memory_order_acquire)) {
+        // The pool is gone: nothing would ever take the parser back
+        return;
+    }
+    const Options& options = state->options;
+    const size_t bytes = parser->retainedBytes();
+    ThreadCache& cache = threadCaches()[state->id];
+    if (cache.state.expired()) {
+        cache.state = state;
+    }
+    if (cache.parsers.size() >= options.max_parsers_per_thread
+        || cache.bytes + bytes > options.max_retained_bytes_per_thread) {
+        // Over the per-thread limits: the parser is simply destroyed
+        return;
+    }
+    cache.bytes += bytes;
+    cache.parsers.push_back(std::move(parser));
+}
+
+} // namespace lazyjson
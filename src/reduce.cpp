@@ -0,0 +1,135 @@
+#include "reduce.hpp"
+#include "tape_util.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace lazyjson {
+
+namespace reduce_detail {
+
+namespace {
+
+    constexpr size_t kBatchSize = 256;
+
+    class NumberScanner {
+    public:
+        NumberScanner(const Parser& parser, const Path& path, const std::function<void(const double*, size_t)>& fn)
+            : tokens_(parser.getTokens()), jumps_(parser.getTokenJumps()), path_(path), fn_(fn) {}
+
+        void run() {
+            if (tokens_.size() < 3) {
+                throw std::runtime_error("Reduce error: no document");
+            }
+            visit(1, 0, false);
+            flush();
+        }
+
+    private:
+        // Last token of the value starting at `index`
+        size_t end(size_t index) const { return tape_detail::valueEnd(tokens_, jumps_, index); }
+
+        void missing(size_t component, bool under_wildcard) const {
+            if (!under_wildcard) {
+                throw std::runtime_error("Reduce error: path component '" + std::string(path_.key(component)) + "' not found");
+            }
+        }
+
+        // Every number directly in the array at `index` (the leaf "[*]" case, kept tight)
+        void numbersOf(size_t index) {
+            const size_t last = end(index);
+            for (size_t i = index + 1; i < last; i++) {
+                const Token& token = tokens_[i];
+                if (token.type == TokenType::TOKEN_NUMBER) {
+                    push(tape_detail::numberValue(token.value));
+                } else if (token.type == TokenType::TOKEN_OBJECT_START || token.type == TokenType::TOKEN_ARRAY_START) {
+                    i = end(i);
+                }
+            }
+        }
+
+        void visit(size_t index, size_t component, bool under_wildcard) {
+            const Token& token = tokens_[index];
+            if (component == path_.size()) {
+                if (token.type == TokenType::TOKEN_NUMBER) push(tape_detail::numberValue(token.value));
+                return;
+            }
+
+            if (path_.isWildcard(component)) {
+                if (token.type != TokenType::TOKEN_ARRAY_START) {
+                    missing(component, under_wildcard);
+                    return;
+                }
+                if (component + 1 == path_.size()) {
+                    numbersOf(index);
+                    return;
+                }
+                const size_t last = end(index);
+                for (size_t i = index + 1; i < last; i = end(i) + 1) {
+                    if (tokens_[i].type == TokenType::TOKEN_COMMA) i++;
+                    visit(i, component + 1, true);
+                }
+                return;
+            }
+
+            if (path_.index(component) != Path::kNoIndex) {
+                if (token.type != TokenType::TOKEN_ARRAY_START) {
+                    missing(component, under_wildcard);
+                    return;
+                }
+                const size_t last = end(index);
+                size_t position = 0;
+                for (size_t i = index + 1; i < last; i = end(i) + 1) {
+                    if (tokens_[i].type == TokenType::TOKEN_COMMA) i++;
+                    if (position++ == path_.index(component)) {
+                        visit(i, component + 1, under_wildcard);
+                        return;
+                    }
+                }
+                missing(component, under_wildcard);
+                return;
+            }
+
+            if (token.type != TokenType::TOKEN_OBJECT_START) {
+                missing(component, under_wildcard);
+                return;
+            }
+            const size_t last = end(index);
+            for (size_t i = index + 1; i < last; i = end(i + 2) + 1) {
+                if (tokens_[i].type == TokenType::TOKEN_COMMA) i++;
+                if (tokens_[i].value == path_.key(component)) {
+                    visit(i + 2, component + 1, under_wildcard);
+                    return;
+                }
+            }
+            missing(component, under_wildcard);
+        }
+
+        inline void push(double value) {
+            buffer_[count_++] = value;
+            if (count_ == kBatchSize) flush();
+        }
+
+        void flush() {
+            if (count_ > 0) {
+                fn_(buffer_, count_);
+                count_ = 0;
+            }
+        }
+
+        const std::vector<Token>& tokens_;
+        const std::vector<size_t>& jumps_;
+        const Path& path_;
+        const std::function<void(const double*, size_t)>& fn_;
+        double buffer_[kBatchSize];
+        size_t count_ = 0;
+    };
+
+} // namespace
+
+void scanNumbers(const Parser& parser, const Path& path, const std::function<void(const double*, size_t)>& fn) {
+    NumberScanner(parser, path, fn).run();
+}
+
+} // namespace reduce_detail
+
+} // namespace lazyjson
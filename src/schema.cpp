@@ -0,0 +1,664 @@
+#include "schema.hpp"
+#include "data.hpp"
+#include "tape_util.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace lazyjson {
+
+namespace {
+
+    using tape_detail::decoded;
+    using tape_detail::numberValue;
+
+    // Keywords with a validation meaning this compiler does not implement
+    const char* const kUnsupportedKeywords[] = {
+        "$ref", "$dynamicRef", "allOf", "anyOf", "oneOf", "not", "if", "then", "else",
+        "pattern", "patternProperties", "propertyNames", "dependencies", "dependentRequired",
+        "dependentSchemas", "contains", "minContains", "maxContains", "uniqueItems",
+        "prefixItems", "additionalItems", "unevaluatedItems", "unevaluatedProperties"
+    };
+
+    // Number of UTF-8 code points
+    size_t codePoints(std::string_view text) {
+        size_t count = 0;
+        for (unsigned char c : text) {
+            count += (c & 0xC0) != 0x80;
+        }
+        return count;
+    }
+
+    const char* typeName(TokenType type) {
+        switch (type) {
+            case TokenType::TOKEN_NULL: return "null";
+            case TokenType::TOKEN_BOOLEAN: return "boolean";
+            case TokenType::TOKEN_NUMBER: return "number";
+            case TokenType::TOKEN_STRING: return "string";
+            case TokenType::TOKEN_ARRAY_START: return "array";
+            case TokenType::TOKEN_OBJECT_START: return "object";
+            default: return "invalid token";
+        }
+    }
+
+    std::string pointerToken(std::string_view key) {
+        std::string token;
+        token.reserve(key.size());
+        for (char c : key) {
+            if (c == '~') token.append("~0");
+            else if (c == '/') token.append("~1");
+            else token.push_back(c);
+        }
+        return token;
+    }
+
+    std::string formatNumber(double value) {
+        std::ostringstream os;
+        os << value;
+        return os.str();
+    }
+
+} // namespace
+
+// Turns the schema tape into nodes; throws std::runtime_error on unsupported input
+class Schema::Compiler {
+public:
+    Compiler(Schema& schema, const std::vector<Token>& tokens) : schema_(schema), tokens_(tokens) {}
+
+    void run() {
+        size_t index = 1;
+        compile(index);
+        if (tokens_[index].type != TokenType::TOKEN_EOF) {
+            throw std::runtime_error("unexpected content after the schema");
+        }
+    }
+
+private:
+    const Token& expect(size_t& index, TokenType type, const char* what) {
+        const Token& token = tokens_[index];
+        if (token.type != type) {
+            throw std::runtime_error(std::string("expected ") + what);
+        }
+        index++;
+        return token;
+    }
+
+    void skip(size_t& index) {
+        const TokenType type = tokens_[index].type;
+        if (type == TokenType::TOKEN_EOF) {
+            throw std::runtime_error("unexpected end of schema");
+        }
+        // The schema tape has no jump table: valueEnd scans for the bracket
+        const size_t last = tape_detail::valueEnd(tokens_, {}, index);
+        const bool container = type == TokenType::TOKEN_OBJECT_START || type == TokenType::TOKEN_ARRAY_START;
+        if ((container && last == index) || type == TokenType::TOKEN_OBJECT_END || type == TokenType::TOKEN_ARRAY_END) {
+            throw std::runtime_error("unbalanced brackets");
+        }
+        index = last + 1;
+    }
+
+    // Calls fn() with `index` on each element of the array at `index`
+    template<typename Fn>
+    void forEachElement(size_t& index, Fn&& fn) {
+        expect(index, TokenType::TOKEN_ARRAY_START, "an array");
+        bool first = true;
+        while (tokens_[index].type != TokenType::TOKEN_ARRAY_END) {
+            if (!first) expect(index, TokenType::TOKEN_COMMA, "','");
+            first = false;
+            fn(index);
+        }
+        index++;
+    }
+
+    // Calls fn(key) with `index` on each member value of the object at `index`
+    template<typename Fn>
+    void forEachMember(size_t& index, Fn&& fn) {
+        expect(index, TokenType::TOKEN_OBJECT_START, "an object");
+        bool first = true;
+        while (tokens_[index].type != TokenType::TOKEN_OBJECT_END) {
+            if (!first) expect(index, TokenType::TOKEN_COMMA, "','");
+            first = false;
+            std::string scratch;
+            const std::string key(decoded(expect(index, TokenType::TOKEN_STRING, "a key").value, scratch));
+            expect(index, TokenType::TOKEN_COLON, "':'");
+            fn(key);
+        }
+        index++;
+    }
+
+    double number(size_t& index) {
+        return numberValue(expect(index, TokenType::TOKEN_NUMBER, "a number").value);
+    }
+
+    size_t count(size_t& index) {
+        const double value = number(index);
+        if (value < 0 || value != std::floor(value)) {
+            throw std::runtime_error("expected a non negative integer");
+        }
+        return static_cast<size_t>(value);
+    }
+
+    bool boolean(size_t& index) {
+        return expect(index, TokenType::TOKEN_BOOLEAN, "a boolean").value == "true";
+    }
+
+    uint8_t typeBit(std::string_view name) {
+        if (name == "null") return TYPE_NULL;
+        if (name == "boolean") return TYPE_BOOLEAN;
+        if (name == "integer") return TYPE_INTEGER;
+        if (name == "number") return TYPE_NUMBER;
+        if (name == "string") return TYPE_STRING;
+        if (name == "array") return TYPE_ARRAY;
+        if (name == "object") return TYPE_OBJECT;
+        throw std::runtime_error("unknown type '" + std::string(name) + "'");
+    }
+
+    void enumValue(size_t& index, std::vector<EnumValue>& values) {
+        const Token& token = tokens_[index];
+        EnumValue value{token.type, 0, {}};
+        switch (token.type) {
+            case TokenType::TOKEN_NULL:
+                break;
+            case TokenType::TOKEN_BOOLEAN:
+                value.text = std::string(token.value);
+                break;
+            case TokenType::TOKEN_NUMBER:
+                value.number = numberValue(token.value);
+                break;
+            case TokenType::TOKEN_STRING: {
+                std::string scratch;
+                value.text = std::string(decoded(token.value, scratch));
+                break;
+            }
+            default:
+                throw std::runtime_error("only scalar enum and const values are supported");
+        }
+        index++;
+        values.push_back(std::move(value));
+    }
+
+    uint32_t compile(size_t& index) {
+        const uint32_t id = static_cast<uint32_t>(schema_.nodes_.size());
+        schema_.nodes_.emplace_back();
+
+        // Boolean schemas: true accepts everything, false nothing
+        if (tokens_[index].type == TokenType::TOKEN_BOOLEAN) {
+            if (!boolean(index)) schema_.nodes_[id].types = 0;
+            return id;
+        }
+
+        // Collected locally: nested schemas append their own ranges meanwhile
+        Node node;
+        std::vector<Property> properties;
+        std::vector<std::string> required;
+        std::vector<EnumValue> enums;
+        bool has_enum = false;
+        bool draft4_exclusive_minimum = false, draft4_exclusive_maximum = false;
+
+        forEachMember(index, [&](const std::string& keyword) {
+            for (const char* unsupported : kUnsupportedKeywords) {
+                if (keyword == unsupported) {
+                    throw std::runtime_error("unsupported keyword '" + keyword + "'");
+                }
+            }
+            if (keyword == "type") {
+                node.types = 0;
+                if (tokens_[index].type == TokenType::TOKEN_ARRAY_START) {
+                    forEachElement(index, [&](size_t& i) {
+                        node.types |= typeBit(expect(i, TokenType::TOKEN_STRING, "a type name").value);
+                    });
+                } else {
+                    node.types = typeBit(expect(index, TokenType::TOKEN_STRING, "a type name").value);
+                }
+            } else if (keyword == "properties") {
+                forEachMember(index, [&](const std::string& key) {
+                    properties.push_back(Property{key, compile(index), -1});
+                });
+            } else if (keyword == "required") {
+                forEachElement(index, [&](size_t& i) {
+                    std::string scratch;
+                    required.emplace_back(decoded(expect(i, TokenType::TOKEN_STRING, "a property name").value, scratch));
+                });
+            } else if (keyword == "additionalProperties") {
+                if (tokens_[index].type != TokenType::TOKEN_BOOLEAN) {
+                    throw std::runtime_error("additionalProperties must be a boolean");
+                }
+                node.additional_properties = boolean(index);
+            } else if (keyword == "items") {
+                if (tokens_[index].type == TokenType::TOKEN_ARRAY_START) {
+                    throw std::runtime_error("tuple 'items' is not supported");
+                }
+                node.items = compile(index);
+            } else if (keyword == "minItems") {
+                node.min_items = count(index);
+            } else if (keyword == "maxItems") {
+                node.max_items = count(index);
+            } else if (keyword == "minProperties") {
+                node.min_properties = count(index);
+            } else if (keyword == "maxProperties") {
+                node.max_properties = count(index);
+            } else if (keyword == "minLength") {
+                node.min_length = count(index);
+            } else if (keyword == "maxLength") {
+                node.max_length = count(index);
+            } else if (keyword == "minimum") {
+                node.has_minimum = true;
+                node.minimum = number(index);
+            } else if (keyword == "maximum") {
+                node.has_maximum = true;
+                node.maximum = number(index);
+            } else if (keyword == "exclusiveMinimum") {
+                // Draft 4: boolean modifier of minimum; later drafts: a bound
+                if (tokens_[index].type == TokenType::TOKEN_BOOLEAN) {
+                    draft4_exclusive_minimum = boolean(index);
+                } else {
+                    node.has_exclusive_minimum = true;
+                    node.exclusive_minimum = number(index);
+                }
+            } else if (keyword == "exclusiveMaximum") {
+                if (tokens_[index].type == TokenType::TOKEN_BOOLEAN) {
+                    draft4_exclusive_maximum = boolean(index);
+                } else {
+                    node.has_exclusive_maximum = true;
+                    node.exclusive_maximum = number(index);
+                }
+            } else if (keyword == "multipleOf") {
+                node.multiple_of = number(index);
+                if (!(node.multiple_of > 0)) throw std::runtime_error("multipleOf must be positive");
+            } else if (keyword == "enum") {
+                has_enum = true;
+                forEachElement(index, [&](size_t& i) { enumValue(i, enums); });
+            } else if (keyword == "const") {
+                has_enum = true;
+                enums.clear();
+                enumValue(index, enums);
+            } else {
+                // Annotations and keywords without validation meaning
+                skip(index);
+            }
+        });
+        // Draft 4 turns minimum/maximum into exclusive bounds (a numeric bound
+        // given as well keeps the tighter of the two)
+        if (draft4_exclusive_minimum && node.has_minimum) {
+            if (!node.has_exclusive_minimum || node.minimum > node.exclusive_minimum) node.exclusive_minimum = node.minimum;
+            node.has_exclusive_minimum = true;
+            node.has_minimum = false;
+        }
+        if (draft4_exclusive_maximum && node.has_maximum) {
+            if (!node.has_exclusive_maximum || node.maximum < node.exclusive_maximum) node.exclusive_maximum = node.maximum;
+            node.has_exclusive_maximum = true;
+            node.has_maximum = false;
+        }
+
+        // Required keys become properties with a bit in the required mask
+        if (required.size() > 64) {
+            throw std::runtime_error("more than 64 required properties");
+        }
+        for (size_t bit = 0; bit < required.size(); bit++) {
+            auto it = std::find_if(properties.begin(), properties.end(),
+                                   [&](const Property& property) { return property.key == required[bit]; });
+            if (it == properties.end()) {
+                properties.push_back(Property{required[bit], kNone, -1});
+                it = properties.end() - 1;
+            }
+            if (it->required_bit < 0) {
+                it->required_bit = static_cast<int32_t>(bit);
+                node.required_mask |= uint64_t{1} << bit;
+            }
+        }
+        std::sort(properties.begin(), properties.end(),
+                  [](const Property& a, const Property& b) { return a.key < b.key; });
+
+        node.properties_begin = static_cast<uint32_t>(schema_.properties_.size());
+        for (auto& property : properties) schema_.properties_.push_back(std::move(property));
+        node.properties_end = static_cast<uint32_t>(schema_.properties_.size());
+        if (has_enum) {
+            node.enums_begin = static_cast<uint32_t>(schema_.enums_.size());
+            for (auto& value : enums) schema_.enums_.push_back(std::move(value));
+            node.enums_end = static_cast<uint32_t>(schema_.enums_.size());
+            // An empty enum accepts nothing
+            if (enums.empty()) node.types = 0;
+        }
+        schema_.nodes_[id] = node;
+        return id;
+    }
+
+    Schema& schema_;
+    const std::vector<Token>& tokens_;
+};
+
+// Walks a document tape against the node table. On failure the error is
+// filled at the offending value and its path is built on the way back up.
+class Schema::Validator {
+public:
+    Validator(const Schema& schema, const std::vector<Token>& tokens, ValidationError& error)
+        : schema_(schema), tokens_(tokens), error_(error) {}
+
+    bool run() {
+        error_ = ValidationError{};
+        if (tokens_.size() < 3 || tokens_.front().type != TokenType::TOKEN_SOF) {
+            return fail(SchemaError::MALFORMED_DOCUMENT, "empty document");
+        }
+        size_t index = 1;
+        if (!value(schema_.nodes_.empty() ? kNone : 0, index)) {
+            return false;
+        }
+        if (tokens_[index].type != TokenType::TOKEN_EOF) {
+            return fail(SchemaError::MALFORMED_DOCUMENT, "unexpected content after the document");
+        }
+        return true;
+    }
+
+private:
+    bool fail(SchemaError error, std::string message) {
+        error_.error = error;
+        error_.path.clear();
+        error_.message = std::move(message);
+        return false;
+    }
+
+    bool prefix(std::string_view component) {
+        error_.path.insert(0, "/" + pointerToken(component));
+        return false;
+    }
+
+    bool mismatch(const Node& node, TokenType type) {
+        std::string expected;
+        static const char* const kNames[] = {"null", "boolean", "integer", "number", "string", "array", "object"};
+        for (int bit = 0; bit < 7; bit++) {
+            if (node.types & (1 << bit)) {
+                if (!expected.empty()) expected.append(" or ");
+                expected.append(kNames[bit]);
+            }
+        }
+        if (expected.empty()) {
+            return fail(SchemaError::TYPE_MISMATCH, "no value is allowed here");
+        }
+        return fail(SchemaError::TYPE_MISMATCH, "expected " + expected + ", got " + typeName(type));
+    }
+
+    bool enumMatch(const Node& node, const Token& token, double number, std::string_view text) const {
+        for (uint32_t i = node.enums_begin; i < node.enums_end; i++) {
+            const EnumValue& value = schema_.enums_[i];
+            if (value.type != token.type) continue;
+            switch (token.type) {
+                case TokenType::TOKEN_NULL: return true;
+                case TokenType::TOKEN_NUMBER: if (value.number == number) return true; break;
+                default: if (value.text == text) return true; break;
+            }
+        }
+        return false;
+    }
+
+    bool number(const Node& node, const Token& token) {
+        const bool integer_only = !(node.types & TYPE_NUMBER);
+        if (!integer_only && !node.has_minimum && !node.has_maximum && !node.has_exclusive_minimum && !node.has_exclusive_maximum
+            && node.multiple_of == 0 && node.enums_end == node.enums_begin) {
+            return true;
+        }
+        const double value = numberValue(token.value);
+        if (integer_only && !(std::isfinite(value) && value == std::floor(value))) {
+            return mismatch(node, token.type);
+        }
+        if (node.has_minimum && !(value >= node.minimum)) {
+            return fail(SchemaError::OUT_OF_RANGE, formatNumber(value) + " is below the minimum of " + formatNumber(node.minimum));
+        }
+        if (node.has_exclusive_minimum && !(value > node.exclusive_minimum)) {
+            return fail(SchemaError::OUT_OF_RANGE, formatNumber(value) + " is not above the exclusive minimum of " + formatNumber(node.exclusive_minimum));
+        }
+        if (node.has_maximum && !(value <= node.maximum)) {
+            return fail(SchemaError::OUT_OF_RANGE, formatNumber(value) + " is above the maximum of " + formatNumber(node.maximum));
+        }
+        if (node.has_exclusive_maximum && !(value < node.exclusive_maximum)) {
+            return fail(SchemaError::OUT_OF_RANGE, formatNumber(value) + " is not below the exclusive maximum of " + formatNumber(node.exclusive_maximum));
+        }
+        if (node.multiple_of > 0) {
+            const double quotient = value / node.multiple_of;
+            if (std::fabs(quotient - std::round(quotient)) > 1e-9 * std::max(1.0, std::fabs(quotient))) {
+                return fail(SchemaError::NOT_MULTIPLE_OF, formatNumber(value) + " is not a multiple of " + formatNumber(node.multiple_of));
+            }
+        }
+        if (node.enums_end != node.enums_begin && !enumMatch(node, token, value, {})) {
+            return fail(SchemaError::ENUM_MISMATCH, "value not in enum");
+        }
+        return true;
+    }
+
+    bool string(const Node& node, const Token& token) {
+        const bool check_length = node.min_length > 0 || node.max_length != SIZE_MAX;
+        if (!check_length && node.enums_end == node.enums_begin) {
+            return true;
+        }
+        const std::string_view text = decoded(token.value, scratch_);
+        if (check_length) {
+            const size_t length = codePoints(text);
+            if (length < node.min_length || length > node.max_length) {
+                return fail(SchemaError::LENGTH_OUT_OF_RANGE, "length " + std::to_string(length) + " is outside ["
+                    + std::to_string(node.min_length) + ", " + (node.max_length == SIZE_MAX ? std::string("inf") : std::to_string(node.max_length)) + "]");
+            }
+        }
+        if (node.enums_end != node.enums_begin && !enumMatch(node, token, 0, text)) {
+            return fail(SchemaError::ENUM_MISMATCH, "value not in enum");
+        }
+        return true;
+    }
+
+    bool array(const Node& node, size_t& index) {
+        index++;
+        size_t count = 0;
+        while (tokens_[index].type != TokenType::TOKEN_ARRAY_END) {
+            if (count > 0) {
+                if (tokens_[index].type != TokenType::TOKEN_COMMA) return fail(SchemaError::MALFORMED_DOCUMENT, "expected ',' or ']'");
+                index++;
+            }
+            if (!value(node.items, index)) {
+                return prefix(std::to_string(count));
+            }
+            count++;
+        }
+        index++;
+        if (count < node.min_items || count > node.max_items) {
+            return fail(SchemaError::ITEMS_OUT_OF_RANGE, std::to_string(count) + " items, expected between "
+                + std::to_string(node.min_items) + " and " + (node.max_items == SIZE_MAX ? std::string("inf") : std::to_string(node.max_items)));
+        }
+        return true;
+    }
+
+    const Property* property(const Node& node, std::string_view key) const {
+        const Property* begin = schema_.properties_.data() + node.properties_begin;
+        const Property* end = schema_.properties_.data() + node.properties_end;
+        const Property* it = std::lower_bound(begin, end, key,
+                                              [](const Property& property, std::string_view k) { return property.key < k; });
+        return it != end && it->key == key ? it : nullptr;
+    }
+
+    bool object(const Node& node, size_t& index) {
+        index++;
+        size_t count = 0;
+        uint64_t seen = 0;
+        while (tokens_[index].type != TokenType::TOKEN_OBJECT_END) {
+            if (count > 0) {
+                if (tokens_[index].type != TokenType::TOKEN_COMMA) return fail(SchemaError::MALFORMED_DOCUMENT, "expected ',' or '}'");
+                index++;
+            }
+            if (tokens_[index].type != TokenType::TOKEN_STRING || tokens_[index + 1].type != TokenType::TOKEN_COLON) {
+                return fail(SchemaError::MALFORMED_DOCUMENT, "expected a key and ':'");
+            }
+            const std::string_view raw_key = tokens_[index].value;
+            const std::string_view key = decoded(raw_key, scratch_);
+            index += 2;
+            uint32_t child = kNone;
+            if (const Property* match = property(node, key)) {
+                child = match->node;
+                if (match->required_bit >= 0) seen |= uint64_t{1} << match->required_bit;
+            } else if (!node.additional_properties) {
+                fail(SchemaError::ADDITIONAL_PROPERTY, "property is not allowed");
+                return prefix(key);
+            }
+            if (!value(child, index)) {
+                std::string component;
+                return prefix(decoded(raw_key, component));
+            }
+            count++;
+        }
+        index++;
+        if (seen != node.required_mask) {
+            for (uint32_t i = node.properties_begin; i < node.properties_end; i++) {
+                const Property& required = schema_.properties_[i];
+                if (required.required_bit >= 0 && !(seen & (uint64_t{1} << required.required_bit))) {
+                    return fail(SchemaError::MISSING_REQUIRED, "missing required property '" + required.key + "'");
+                }
+            }
+        }
+        if (count < node.min_properties || count > node.max_properties) {
+            return fail(SchemaError::PROPERTIES_OUT_OF_RANGE, std::to_string(count) + " properties, expected between "
+                + std::to_string(node.min_properties) + " and " + (node.max_properties == SIZE_MAX ? std::string("inf") : std::to_string(node.max_properties)));
+        }
+        return true;
+    }
+
+    bool value(uint32_t id, size_t& index) {
+        static const Node kAny;
+        const Node& node = id == kNone ? kAny : schema_.nodes_[id];
+        const Token& token = tokens_[index];
+        switch (token.type) {
+            case TokenType::TOKEN_NULL:
+                index++;
+                if (!(node.types & TYPE_NULL)) return mismatch(node, token.type);
+                if (node.enums_end != node.enums_begin && !enumMatch(node, token, 0, {})) {
+                    return fail(SchemaError::ENUM_MISMATCH, "value not in enum");
+                }
+                return true;
+            case TokenType::TOKEN_BOOLEAN:
+                index++;
+                if (!(node.types & TYPE_BOOLEAN)) return mismatch(node, token.type);
+                if (node.enums_end != node.enums_begin && !enumMatch(node, token, 0, token.value)) {
+                    return fail(SchemaError::ENUM_MISMATCH, "value not in enum");
+                }
+                return true;
+            case TokenType::TOKEN_NUMBER:
+                index++;
+                if (!(node.types & (TYPE_NUMBER | TYPE_INTEGER))) return mismatch(node, token.type);
+                return number(node, token);
+            case TokenType::TOKEN_STRING:
+                index++;
+                if (!(node.types & TYPE_STRING)) return mismatch(node, token.type);
+                return string(node, token);
+            case TokenType::TOKEN_ARRAY_START:
+                if (!(node.types & TYPE_ARRAY)) return mismatch(node, token.type);
+                if (node.enums_end != node.enums_begin) return fail(SchemaError::ENUM_MISMATCH, "value not in enum");
+                return array(node, index);
+            case TokenType::TOKEN_OBJECT_START:
+                if (!(node.types & TYPE_OBJECT)) return mismatch(node, token.type);
+                if (node.enums_end != node.enums_begin) return fail(SchemaError::ENUM_MISMATCH, "value not in enum");
+                return object(node, index);
+            default:
+                return fail(SchemaError::MALFORMED_DOCUMENT, "expected a value");
+        }
+    }
+
+    const Schema& schema_;
+    const std::vector<Token>& tokens_;
+    ValidationError& error_;
+    std::string scratch_;
+};
+
+int Schema::compile(std::string_view schema, std::string& message) {
+    nodes_.clear();
+    properties_.clear();
+    enums_.clear();
+
+    Tokenizer tokenizer;
+    TokenizerError tokenizer_error = TokenizerError::NONE;
+    if (tokenizer.tokenize(schema, tokenizer_error) != 0) {
+        std::ostringstream os;
+        os << "schema tokenization failed: " << tokenizer_error;
+        message = os.str();
+        return 1;
+    }
+    std::vector<Token> tokens;
+    tokenizer.swapTokens(tokens);
+
+    try {
+        Compiler(*this, tokens).run();
+    } catch (const std::exception& e) {
+        nodes_.clear();
+        properties_.clear();
+        enums_.clear();
+        message = std::string("invalid schema: ") + e.what();
+        return 1;
+    }
+    message.clear();
+    return 0;
+}
+
+bool Schema::validate(const std::vector<Token>& tokens, ValidationError& error) const {
+    return Validator(*this, tokens, error).run();
+}
+
+bool Schema::validate(std::string_view json, ValidationError& error) const {
+    thread_local Tokenizer tokenizer;
+    thread_local std::vector<Token> tokens;
+    TokenizerError tokenizer_error = TokenizerError::NONE;
+    if (tokenizer.tokenize(json, tokenizer_error) != 0) {
+        std::ostringstream os;
+        os << "tokenization failed: " << tokenizer_error;
+        error = ValidationError{SchemaError::MALFORMED_DOCUMENT, "", os.str()};
+        return false;
+    }
+    tokenizer.swapTokens(tokens);
+    return validate(tokens, error);
+}
+
+bool Schema::validate(const Parser& parser, ValidationError& error) const {
+    return validate(parser.getTokens(), error);
+}
+
+std::ostream& operator<<(std::ostream& os, const SchemaError& error) {
+    switch (error) {
+        case SchemaError::NONE:
+            os << "NONE";
+            break;
+        case SchemaError::INVALID_SCHEMA:
+            os << "INVALID_SCHEMA";
+            break;
+        case SchemaError::MALFORMED_DOCUMENT:
+            os << "MALFORMED_DOCUMENT";
+            break;
+        case SchemaError::TYPE_MISMATCH:
+            os << "TYPE_MISMATCH";
+            break;
+        case SchemaError::MISSING_REQUIRED:
+            os << "MISSING_REQUIRED";
+            break;
+        case SchemaError::ADDITIONAL_PROPERTY:
+            os << "ADDITIONAL_PROPERTY";
+            break;
+        case SchemaError::ENUM_MISMATCH:
+            os << "ENUM_MISMATCH";
+            break;
+        case SchemaError::OUT_OF_RANGE:
+            os << "OUT_OF_RANGE";
+            break;
+        case SchemaError::LENGTH_OUT_OF_RANGE:
+            os << "LENGTH_OUT_OF_RANGE";
+            break;
+        case SchemaError::ITEMS_OUT_OF_RANGE:
+            os << "ITEMS_OUT_OF_RANGE";
+            break;
+        case SchemaError::PROPERTIES_OUT_OF_RANGE:
+            os << "PROPERTIES_OUT_OF_RANGE";
+            break;
+        case SchemaError::NOT_MULTIPLE_OF:
+            os << "NOT_MULTIPLE_OF";
+            break;
+        default:
+            os << "UNKNOWN_ERROR";
+            break;
+    }
+    return os;
+}
+
+} // namespace lazyjson
@@ -0,0 +1,132 @@
+#include "shape.hpp"
+#include "hash.hpp"
+#include <mutex>
+
+namespace lazyjson {
+
+Shape::Shape(const std::vector<std::string_view>& keys, uint64_t hash, KeyInterner* interner)
+    : hash_(hash), interner_(interner) {
+    size_t total = 0;
+    for (const auto& key : keys) {
+        total += key.size();
+    }
+    // A single allocation for every key, the views below never move
+    storage_.reserve(total);
+    for (const auto& key : keys) {
+        storage_.append(key);
+    }
+    keys_.reserve(keys.size());
+    slots_.reserve(keys.size());
+    size_t offset = 0;
+    for (const auto& key : keys) {
+        std::string_view stored(storage_.data() + offset, key.size());
+        offset += key.size();
+        slots_.emplace(stored, keys_.size());
+        keys_.push_back(stored);
+    }
+    if (interner) {
+        ids_.reserve(keys_.size());
+        for (const auto& key : keys_) {
+            ids_.push_back(interner->intern(key));
+        }
+    }
+}
+
+bool Shape::matches(const std::vector<std::string_view>& keys) const {
+    if (keys.size() != keys_.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] != keys_[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t ShapeCache::hashKeys(const std::vector<std::string_view>& keys) {
+    uint64_t hash = keys.size();
+    for (const auto& key : keys) {
+        hash = hashMix(hash ^ hashKey(key));
+    }
+    return hash;
+}
+
+std::shared_ptr<const Shape> ShapeCache::find(const ShapeMap& shapes, const std::vector<std::string_view>& keys, uint64_t hash) {
+    auto range = shapes.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->matches(keys)) {
+            return it->second;
+        }
+    }
+    return nullptr;
+}
+
+bool ShapeCache::distinctKeys(const std::vector<std::string_view>& keys) {
+    // Objects are small (at most max_keys_ keys): pairwise compares, no allocation
+    for (size_t i = 1; i < keys.size(); i++) {
+        for (size_t j = 0; j < i; j++) {
+            if (keys[i] == keys[j]) return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<const Shape> ShapeCache::intern(const std::vector<std::string_view>& keys, uint64_t hash) {
+    if (keys.empty() || keys.size() > max_keys_) {
+        return nullptr;
+    }
+    bool full;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (auto shape = find(shapes_, keys, hash)) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return shape;
+        }
+        if (find(rejected_, keys, hash)) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        full = shapes_.size() >= max_shapes_;
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    // Nothing is built for a layout that cannot be cached: a full cache costs one lookup
+    if (full) {
+        return nullptr;
+    }
+
+    if (!distinctKeys(keys)) {
+        // Duplicate keys: the first occurrence wins, which a slot array cannot express.
+        // Remembered without interning, so the interner only holds keys of cached shapes
+        auto rejected = std::make_shared<const Shape>(keys, hash);
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (rejected_.size() < max_shapes_ && !find(rejected_, keys, hash)) {
+            rejected_.emplace(hash, std::move(rejected));
+        }
+        return nullptr;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (auto existing = find(shapes_, keys, hash)) {
+        return existing;
+    }
+    if (shapes_.size() >= max_shapes_) {
+        return nullptr;
+    }
+    auto shape = std::make_shared<const Shape>(keys, hash, interner_.get());
+    shapes_.emplace(hash, shape);
+    return shape;
+}
+
+size_t ShapeCache::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return shapes_.size();
+}
+
+void ShapeCache::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    shapes_.clear();
+    rejected_.clear();
+}
+
+} // namespace lazyjson
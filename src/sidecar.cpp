@@ -0,0 +1,339 @@
+#include "sidecar.hpp"
+#include "hash.hpp"
+#include "large_document.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lazyjson {
+
+    namespace {
+
+        constexpr char kTapeMagic[8] = {'L', 'Z', 'J', 'T', 'A', 'P', 'E', '\0'};
+        // Version 1: 32 bit offsets and jumps, version 2: 64 bit
+        constexpr uint32_t kTapeVersion = 1;
+        constexpr uint32_t kTapeVersionWide = 2;
+
+        constexpr size_t align8(size_t size) { return (size + 7) & ~size_t(7); }
+
+        // Byte offset of each section for a given token count
+        struct TapeLayout {
+            size_t offsets, lengths, jumps, types, total;
+
+            TapeLayout(size_t count, bool wide) {
+                const size_t index_size = wide ? sizeof(uint64_t) : sizeof(uint32_t);
+                offsets = align8(sizeof(TapeHeader));
+                lengths = offsets + align8(count * index_size);
+                jumps = lengths + align8(count * sizeof(uint32_t));
+                types = jumps + align8(count * index_size);
+                total = types + align8(count * sizeof(uint8_t));
+            }
+        };
+
+        // The jumps must pair every bracket with the matching one, properly nested,
+        // and be the own index of every other token: the lazy parser follows them
+        // blindly, and the content hash only covers the source, not the tape
+        bool validJumps(const std::vector<Token>& tokens, const std::vector<size_t>& jumps) {
+            std::vector<size_t> open;
+            for (size_t i = 0; i < tokens.size(); i++) {
+                const TokenType type = tokens[i].type;
+                if (type == TokenType::TOKEN_OBJECT_START || type == TokenType::TOKEN_ARRAY_START) {
+                    if (jumps[i] <= i) return false;
+                    open.push_back(i);
+                } else if (type == TokenType::TOKEN_OBJECT_END || type == TokenType::TOKEN_ARRAY_END) {
+                    if (open.empty()) return false;
+                    const size_t start = open.back();
+                    open.pop_back();
+                    const TokenType expected = tokens[start].type == TokenType::TOKEN_OBJECT_START
+                        ? TokenType::TOKEN_OBJECT_END : TokenType::TOKEN_ARRAY_END;
+                    if (type != expected || jumps[start] != i || jumps[i] != start) return false;
+                } else if (jumps[i] != i) {
+                    return false;
+                }
+            }
+            return open.empty();
+        }
+
+        // Tokens of one tape version from its mapped sections
+        template<typename Index>
+        bool decodeTape(const char* data, const TapeLayout& layout, size_t count, std::string_view source,
+                        std::vector<Token>& tokens, std::vector<size_t>& jumps) {
+            const auto* offsets = reinterpret_cast<const Index*>(data + layout.offsets);
+            const auto* lengths = reinterpret_cast<const uint32_t*>(data + layout.lengths);
+            const auto* jump = reinterpret_cast<const Index*>(data + layout.jumps);
+            const auto* types = reinterpret_cast<const uint8_t*>(data + layout.types);
+
+            reserveTape(tokens, count);
+            reserveTape(jumps, count);
+            tokens.resize(count);
+            jumps.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                // A corrupted tape must not produce views outside the source
+                if (offsets[i] > source.size() || lengths[i] > source.size() - offsets[i]
+                    || types[i] > static_cast<uint8_t>(TokenType::TOKEN_ERROR)
+                    || jump[i] >= count) {
+                    tokens.clear();
+                    jumps.clear();
+                    return false;
+                }
+                tokens[i] = Token{static_cast<TokenType>(types[i]), std::string_view(source.data() + offsets[i], lengths[i])};
+                jumps[i] = static_cast<size_t>(jump[i]);
+            }
+            if (!validJumps(tokens, jumps)) {
+                tokens.clear();
+                jumps.clear();
+                return false;
+            }
+            return true;
+        }
+
+        // Writes one section through a bounded buffer, so huge tapes do not need a second full copy in memory
+        template<typename T, typename Fn>
+        bool writeSection(std::FILE* file, size_t count, Fn&& value) {
+            constexpr size_t kChunk = 16384;
+            T buffer[kChunk];
+            for (size_t start = 0; start < count; start += kChunk) {
+                size_t n = std::min(kChunk, count - start);
+                for (size_t i = 0; i < n; i++) {
+                    buffer[i] = static_cast<T>(value(start + i));
+                }
+                if (std::fwrite(buffer, sizeof(T), n, file) != n) return false;
+            }
+            static const char padding[8] = {};
+            size_t pad = align8(count * sizeof(T)) - count * sizeof(T);
+            return pad == 0 || std::fwrite(padding, 1, pad, file) == pad;
+        }
+
+        // New file next to `target`, with a name no other writer (thread or process)
+        // uses: concurrent saves of the same tape each rename a complete file
+        std::FILE* openTemporary(const std::string& target, std::string& path) {
+            static std::atomic<uint64_t> counter{0};
+            for (int attempt = 0; attempt < 16; attempt++) {
+                path = target + ".tmp." + std::to_string(getpid()) + "." + std::to_string(counter.fetch_add(1));
+                // O_EXCL: never truncate a file someone else is writing
+                const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+                if (fd >= 0) {
+                    std::FILE* file = fdopen(fd, "wb");
+                    if (!file) {
+                        ::close(fd);
+                        std::remove(path.c_str());
+                    }
+                    return file;
+                }
+                if (errno != EEXIST) break;
+            }
+            return nullptr;
+        }
+
+    } // namespace
+
+    std::ostream& operator<<(std::ostream& os, const TapeError& error) {
+        switch (error) {
+            case TapeError::NONE:
+                os << "NONE";
+                break;
+            case TapeError::IO_ERROR:
+                os << "IO_ERROR";
+                break;
+            case TapeError::INVALID_FORMAT:
+                os << "INVALID_FORMAT";
+                break;
+            case TapeError::SOURCE_MISMATCH:
+                os << "SOURCE_MISMATCH";
+                break;
+            case TapeError::SOURCE_TOO_LARGE:
+                os << "SOURCE_TOO_LARGE";
+                break;
+            default:
+                os << "UNKNOWN_ERROR";
+                break;
+        }
+        return os;
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    int MappedFile::open(const std::string& path, TapeError& error) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = TapeError::IO_ERROR;
+            return 1;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            error = TapeError::IO_ERROR;
+            return 1;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                size_ = 0;
+                error = TapeError::IO_ERROR;
+                return 1;
+            }
+            data_ = static_cast<const char*>(mapping);
+        }
+        // The mapping stays valid after the descriptor is closed
+        ::close(fd);
+        error = TapeError::NONE;
+        return 0;
+    }
+
+    void MappedFile::close() {
+        if (data_) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    void MappedFile::adviseSequential() const {
+        if (data_) {
+            madvise(const_cast<char*>(data_), size_, MADV_SEQUENTIAL);
+        }
+    }
+
+    void MappedFile::discard(size_t offset) const {
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t length = std::min(offset, size_) / page * page;
+        if (data_ && length > 0) {
+            madvise(const_cast<char*>(data_), length, MADV_DONTNEED);
+        }
+    }
+
+    void computeJumps(const std::vector<Token>& tokens, std::vector<size_t>& jumps) {
+        reserveTape(jumps, tokens.size());
+        jumps.resize(tokens.size());
+        std::vector<size_t> open;
+        for (size_t i = 0; i < tokens.size(); i++) {
+            jumps[i] = i;
+            switch (tokens[i].type) {
+                case TokenType::TOKEN_OBJECT_START:
+                case TokenType::TOKEN_ARRAY_START:
+                    open.push_back(i);
+                    break;
+                case TokenType::TOKEN_OBJECT_END:
+                case TokenType::TOKEN_ARRAY_END:
+                    if (!open.empty()) {
+                        jumps[i] = open.back();
+                        jumps[open.back()] = i;
+                        open.pop_back();
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    int writeTape(const std::string& tape_path, std::string_view source,
+                  const std::vector<Token>& tokens, const std::vector<size_t>& jumps, TapeError& error) {
+        error = TapeError::NONE;
+        if (jumps.size() != tokens.size()) {
+            error = TapeError::INVALID_FORMAT;
+            return 1;
+        }
+        const bool wide = source.size() > std::numeric_limits<uint32_t>::max()
+                       || tokens.size() > std::numeric_limits<uint32_t>::max();
+        // Lengths stay 32 bit in both layouts: a single value of 4 GB is refused
+        for (size_t i = 0; wide && i < tokens.size(); i++) {
+            if (tokens[i].value.size() > std::numeric_limits<uint32_t>::max()) {
+                error = TapeError::SOURCE_TOO_LARGE;
+                return 1;
+            }
+        }
+
+        TapeHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kTapeMagic, sizeof(kTapeMagic));
+        header.version = wide ? kTapeVersionWide : kTapeVersion;
+        header.source_size = source.size();
+        header.source_hash = hashBytes(source);
+        header.token_count = tokens.size();
+
+        // Write to a temporary file and rename, so a reader never sees a half written tape
+        std::string tmp_path;
+        std::FILE* file = openTemporary(tape_path, tmp_path);
+        if (!file) {
+            error = TapeError::IO_ERROR;
+            return 1;
+        }
+        const char* base = source.data();
+        static const char padding[8] = {};
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+            && std::fwrite(padding, 1, align8(sizeof(header)) - sizeof(header), file) == align8(sizeof(header)) - sizeof(header)
+            && (wide ? writeSection<uint64_t>(file, tokens.size(), [&](size_t i) { return tokens[i].value.data() - base; })
+                     : writeSection<uint32_t>(file, tokens.size(), [&](size_t i) { return tokens[i].value.data() - base; }))
+            && writeSection<uint32_t>(file, tokens.size(), [&](size_t i) { return tokens[i].value.size(); })
+            && (wide ? writeSection<uint64_t>(file, tokens.size(), [&](size_t i) { return jumps[i]; })
+                     : writeSection<uint32_t>(file, tokens.size(), [&](size_t i) { return jumps[i]; }))
+            && writeSection<uint8_t>(file, tokens.size(), [&](size_t i) { return static_cast<uint8_t>(tokens[i].type); });
+        ok = (std::fclose(file) == 0) && ok;
+        if (!ok || std::rename(tmp_path.c_str(), tape_path.c_str()) != 0) {
+            std::remove(tmp_path.c_str());
+            error = TapeError::IO_ERROR;
+            return 1;
+        }
+        return 0;
+    }
+
+    int readTape(const std::string& tape_path, std::string_view source, TapeValidation validation,
+                 std::vector<Token>& tokens, std::vector<size_t>& jumps, TapeError& error) {
+        MappedFile tape;
+        if (tape.open(tape_path, error) != 0) {
+            return 1;
+        }
+
+        TapeHeader header;
+        if (tape.size() < sizeof(header)) {
+            error = TapeError::INVALID_FORMAT;
+            return 1;
+        }
+        std::memcpy(&header, tape.data(), sizeof(header));
+        if (std::memcmp(header.magic, kTapeMagic, sizeof(kTapeMagic)) != 0
+            || (header.version != kTapeVersion && header.version != kTapeVersionWide)) {
+            error = TapeError::INVALID_FORMAT;
+            return 1;
+        }
+        if (header.source_size != source.size()
+            || (validation == TapeValidation::CONTENT_HASH && header.source_hash != hashBytes(source))) {
+            error = TapeError::SOURCE_MISMATCH;
+            return 1;
+        }
+        const size_t count = header.token_count;
+        const bool wide = header.version == kTapeVersionWide;
+        if (count > tape.size()) {
+            error = TapeError::INVALID_FORMAT;
+            return 1;
+        }
+        const TapeLayout layout(count, wide);
+        if (layout.total > tape.size()) {
+            error = TapeError::INVALID_FORMAT;
+            return 1;
+        }
+
+        const bool decoded = wide ? decodeTape<uint64_t>(tape.data(), layout, count, source, tokens, jumps)
+                                  : decodeTape<uint32_t>(tape.data(), layout, count, source, tokens, jumps);
+        if (!decoded) {
+            error = TapeError::INVALID_FORMAT;
+            return 1;
+        }
+        error = TapeError::NONE;
+        return 0;
+    }
+
+} // namespace lazyjson
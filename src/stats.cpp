@@ -0,0 +1,32 @@
+#include "stats.hpp"
+
+namespace lazyjson {
+
+    std::ostream& operator<<(std::ostream& os, const ParserStats& stats) {
+        os << "{\"tokens\":{";
+        for (size_t i = 0; i < kTokenTypeCount; i++) {
+            if (i) os << ",";
+            os << "\"" << static_cast<TokenType>(i) << "\":" << stats.tokens_by_type[i];
+        }
+        os << "}"
+           << ",\"bytes_scanned\":" << stats.bytes_scanned
+           << ",\"tokenize_ns\":" << stats.tokenize_ns
+           << ",\"parse_ns\":" << stats.parse_ns
+           << ",\"materialize_ns\":" << stats.materialize_ns
+           << ",\"dump_ns\":" << stats.dump_ns
+           << ",\"nodes_registered\":" << stats.nodes_registered
+           << ",\"nodes_materialized\":" << stats.nodes_materialized
+           << ",\"string_buffer_bytes\":" << stats.string_buffer_bytes
+           << ",\"string_buffer_capacity\":" << stats.string_buffer_capacity
+           << ",\"string_buffer_blocks\":" << stats.string_buffer_blocks
+           << ",\"string_buffer_wasted\":" << stats.string_buffer_wasted
+           << ",\"shaped_objects\":" << stats.shaped_objects
+           << ",\"path_cache_hits\":" << stats.path_cache_hits
+           << ",\"path_cache_misses\":" << stats.path_cache_misses
+           << ",\"memory_bytes\":" << stats.memory_bytes
+           << ",\"peak_memory_bytes\":" << stats.peak_memory_bytes
+           << "}";
+        return os;
+    }
+
+} // namespace lazyjson
@@ -0,0 +1,147 @@
+#include "tape_util.hpp"
+#include "data.hpp"
+#include <charconv>
+#include <cstdlib>
+
+namespace lazyjson {
+
+namespace tape_detail {
+
+    size_t valueEnd(const std::vector<Token>& tokens, const std::vector<size_t>& jumps, size_t index) {
+        const TokenType type = tokens[index].type;
+        if (type != TokenType::TOKEN_OBJECT_START && type != TokenType::TOKEN_ARRAY_START) {
+            return index;
+        }
+        if (jumps.size() == tokens.size()) {
+            return jumps[index];
+        }
+        size_t depth = 0;
+        for (size_t i = index; i < tokens.size(); i++) {
+            switch (tokens[i].type) {
+                case TokenType::TOKEN_OBJECT_START:
+                case TokenType::TOKEN_ARRAY_START:
+                    depth++;
+                    break;
+                case TokenType::TOKEN_OBJECT_END:
+                case TokenType::TOKEN_ARRAY_END:
+                    if (--depth == 0) return i;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return index;
+    }
+
+    bool parseNumber(std::string_view text, double& out) {
+        const char* p = text.data();
+        const char* end = p + text.size();
+        const bool negative = p < end && *p == '-';
+        if (negative) p++;
+        // Up to 18 digits fit in a uint64_t without overflow
+        if (p < end && end - p <= 18) {
+            uint64_t value = 0;
+            const char* q = p;
+            while (q < end && static_cast<unsigned>(*q - '0') < 10) {
+                value = value * 10 + static_cast<uint64_t>(*q - '0');
+                q++;
+            }
+            if (q == end) {
+                out = negative ? -static_cast<double>(value) : static_cast<double>(value);
+                return true;
+            }
+        }
+        auto result = std::from_chars(text.data(), end, out);
+        if (result.ec == std::errc() && result.ptr == end) {
+            return true;
+        }
+        const std::string copy(text);
+        char* stop = nullptr;
+        out = std::strtod(copy.c_str(), &stop);
+        return !copy.empty() && stop == copy.c_str() + copy.size();
+    }
+
+    bool integerText(std::string_view text, std::string& out) {
+        out.clear();
+        size_t i = 0;
+        const bool negative = i < text.size() && text[i] == '-';
+        if (negative) {
+            out.push_back('-');
+            i++;
+        }
+        const size_t first_digit = out.size();
+        int64_t exponent = 0;
+        bool fraction = false;
+        bool any_digit = false;
+        for (; i < text.size(); i++) {
+            const char c = text[i];
+            if (c >= '0' && c <= '9') {
+                any_digit = true;
+                if (fraction) exponent--;
+                // Leading zeros are not significant
+                if (c != '0' || out.size() > first_digit) out.push_back(c);
+            } else if (c == '.' && !fraction) {
+                fraction = true;
+            } else {
+                break;
+            }
+        }
+        if (!any_digit) return false;
+        if (i < text.size()) {
+            if (text[i] != 'e' && text[i] != 'E') return false;
+            i++;
+            const bool negative_exponent = i < text.size() && text[i] == '-';
+            if (i < text.size() && (text[i] == '-' || text[i] == '+')) i++;
+            if (i == text.size()) return false;
+            int64_t value = 0;
+            for (; i < text.size(); i++) {
+                if (text[i] < '0' || text[i] > '9') return false;
+                // Saturate: far beyond any exponent a double or a digit string can use
+                if (value < 1000000000000000LL) value = value * 10 + (text[i] - '0');
+            }
+            exponent += negative_exponent ? -value : value;
+        }
+        while (out.size() > first_digit && out.back() == '0') {
+            out.pop_back();
+            exponent++;
+        }
+        if (out.size() == first_digit) {
+            // -0 and 0 are the same number
+            out = "0";
+            return true;
+        }
+        if (exponent < 0) {
+            return false;
+        }
+        out.push_back('e');
+        out.append(std::to_string(exponent));
+        return true;
+    }
+
+    bool sameNumber(std::string_view a, std::string_view b) {
+        if (a == b) {
+            return true;
+        }
+        std::string text_a, text_b;
+        const bool integer_a = integerText(a, text_a);
+        const bool integer_b = integerText(b, text_b);
+        if (integer_a || integer_b) {
+            return integer_a && integer_b && text_a == text_b;
+        }
+        return numberValue(a) == numberValue(b);
+    }
+
+    std::string_view decoded(std::string_view escaped, std::string& scratch) {
+        if (escaped.find('\\') == std::string_view::npos) {
+            return escaped;
+        }
+        scratch.clear();
+        if (!unescapeString(escaped, scratch)) {
+            return escaped;
+        }
+        return scratch;
+    }
+
+} // namespace tape_detail
+
+} // namespace lazyjson
@@ -1,6 +1,9 @@
 #include "tokenizer.hpp"
+#include "large_document.hpp"
 #include <stdexcept>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <sstream>
 
 namespace lazyjson {
@@ -45,6 +48,10 @@ namespace lazyjson {
     
     int Tokenizer::tokenize(std::string_view jsonString_, TokenizerError& errorOut) {
         tokens_.clear();
+        const bool large = jsonString_.size() >= kLargeDocumentBytes;
+        if (large) {
+            reserveTape(tokens_, estimateTokenCount(jsonString_));
+        }
         errorOut = TokenizerError::NONE;
         tokens_.push_back({TokenType::TOKEN_SOF, {jsonString_.begin(), 0}});
         auto it = jsonString_.begin();
@@ -56,6 +63,11 @@ namespace lazyjson {
 
             if (it == jsonString_.end()) break;
 
+            // Each pass adds at most one token: extend the tape before it is full
+            if (large && tokens_.size() == tokens_.capacity()) {
+                growTape(tokens_, estimateTokenCount(jsonString_.substr(static_cast<size_t>(it - jsonString_.begin()))) + 1);
+            }
+
             switch (*it) {
                 case '{': tokens_.push_back({TokenType::TOKEN_OBJECT_START, {it++, 1}}); break;
                 case '}': tokens_.push_back({TokenType::TOKEN_OBJECT_END, {it++, 1}}); break;
@@ -65,9 +77,10 @@ namespace lazyjson {
                 case ',': tokens_.push_back({TokenType::TOKEN_COMMA, {it++, 1}}); break;
                 case '"': {
                     auto start = it + 1;
-                    auto end = findStringEnd(it);
+                    auto end = findStringEnd(it, jsonString_.end());
                     if (end == jsonString_.end()){
                         errorOut = TokenizerError::UNTERMINATED_STRING;
+                        error_offset_ = static_cast<size_t>(it - jsonString_.begin());
                         return 1;
                     }
                     tokens_.push_back({TokenType::TOKEN_STRING, {start, static_cast<size_t>(end - start)}});
@@ -99,6 +112,7 @@ namespace lazyjson {
                         break;
                     }
                     errorOut = TokenizerError::UNEXPECTED_CHARACTER;
+                    error_offset_ = static_cast<size_t>(it - jsonString_.begin());
                     return 1;
                 case 't':
                     if (jsonString_.substr(it - jsonString_.begin(), 4) == "true") {
@@ -107,6 +121,7 @@ namespace lazyjson {
                         break;
                     }
                     errorOut = TokenizerError::UNEXPECTED_CHARACTER;
+                    error_offset_ = static_cast<size_t>(it - jsonString_.begin());
                     return 1;
                 case 'f':
                     if (jsonString_.substr(it - jsonString_.begin(), 5) == "false") {
@@ -115,10 +130,12 @@ namespace lazyjson {
                         break;
                     }
                     errorOut = TokenizerError::UNEXPECTED_CHARACTER;
+                    error_offset_ = static_cast<size_t>(it - jsonString_.begin());
                     return 1;
                 default:
                     if (!std::isspace(*it)) {
                         errorOut = TokenizerError::UNEXPECTED_CHARACTER;
+                        error_offset_ = static_cast<size_t>(it - jsonString_.begin());
                         return 1;
                     } else {
                         ++it; // Skip whitespace
@@ -126,19 +143,221 @@ namespace lazyjson {
                     break;
             }
         }
+        if (large && tokens_.size() == tokens_.capacity()) {
+            growTape(tokens_, 1);
+        }
         tokens_.push_back({TokenType::TOKEN_EOF, {jsonString_.end(), 0}});
         return 0;
     }
 
-    std::string_view::iterator Tokenizer::findStringEnd(std::string_view::iterator start) {
+    std::string_view::iterator Tokenizer::findStringEnd(std::string_view::iterator start, std::string_view::iterator end) {
         auto it = start + 1;
-        while (it != jsonString_.end()) {
-            if (*it == '"' && *(it - 1) != '\\') {
+        while (it != end) {
+            if (*it == '\\') {
+                // Skip the escaped character (an escaped '\\' must not escape the quote)
+                if (++it == end) break;
+            } else if (*it == '"') {
                 return it;
             }
             ++it;
         }
-        return jsonString_.end();
+        return end;
+    }
+
+    void StreamTokenizer::clear() {
+        buffer_.clear();
+        tokens_.clear();
+        jumps_.clear();
+        open_.clear();
+        pos_ = 0;
+        token_start_ = 0;
+        state_ = State::VALUE;
+        started_ = false;
+        finished_ = false;
+    }
+
+    void StreamTokenizer::push(TokenType type, size_t offset, size_t length) {
+        const size_t index = tokens_.size();
+        tokens_.push_back({type, std::string_view(buffer_.data() + offset, length)});
+        jumps_.push_back(index);
+        switch (type) {
+            case TokenType::TOKEN_OBJECT_START:
+            case TokenType::TOKEN_ARRAY_START:
+                open_.push_back(index);
+                break;
+            case TokenType::TOKEN_OBJECT_END:
+            case TokenType::TOKEN_ARRAY_END:
+                if (!open_.empty()) {
+                    jumps_[index] = open_.back();
+                    jumps_[open_.back()] = index;
+                    open_.pop_back();
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void StreamTokenizer::grow(size_t required) {
+        // Move the buffer by hand so the tokens can be rebased while the old one is alive
+        std::string bigger;
+        bigger.reserve(std::max(required, std::max<size_t>(buffer_.capacity() * 2, 4096)));
+        bigger.assign(buffer_);
+        const char* old_data = buffer_.data();
+        for (auto& token : tokens_) {
+            token.value = std::string_view(bigger.data() + (token.value.data() - old_data), token.value.size());
+        }
+        buffer_.swap(bigger);
+    }
+
+    void StreamTokenizer::reserve(size_t bytes) {
+        if (bytes > buffer_.capacity()) {
+            grow(bytes);
+        }
+    }
+
+    int StreamTokenizer::feed(std::string_view chunk, TokenizerError& errorOut) {
+        errorOut = TokenizerError::NONE;
+        if (buffer_.size() + chunk.size() > buffer_.capacity()) {
+            grow(buffer_.size() + chunk.size());
+        }
+        if (!started_) {
+            started_ = true;
+            push(TokenType::TOKEN_SOF, 0, 0);
+        }
+        buffer_.append(chunk.data(), chunk.size());
+        return scan(false, errorOut);
+    }
+
+    int StreamTokenizer::finish(TokenizerError& errorOut) {
+        errorOut = TokenizerError::NONE;
+        if (!started_) {
+            started_ = true;
+            push(TokenType::TOKEN_SOF, 0, 0);
+        }
+        if (scan(true, errorOut) != 0) {
+            return 1;
+        }
+        push(TokenType::TOKEN_EOF, buffer_.size(), 0);
+        finished_ = true;
+        return 0;
+    }
+
+    int StreamTokenizer::scan(bool final, TokenizerError& errorOut) {
+        const char* data = buffer_.data();
+        const size_t size = buffer_.size();
+        while (pos_ < size) {
+            switch (state_) {
+                case State::VALUE: {
+                    const char c = data[pos_];
+                    switch (c) {
+                        case '{': push(TokenType::TOKEN_OBJECT_START, pos_++, 1); break;
+                        case '}': push(TokenType::TOKEN_OBJECT_END, pos_++, 1); break;
+                        case '[': push(TokenType::TOKEN_ARRAY_START, pos_++, 1); break;
+                        case ']': push(TokenType::TOKEN_ARRAY_END, pos_++, 1); break;
+                        case ':': push(TokenType::TOKEN_COLON, pos_++, 1); break;
+                        case ',': push(TokenType::TOKEN_COMMA, pos_++, 1); break;
+                        case '"':
+                            token_start_ = ++pos_;
+                            state_ = State::STRING;
+                            break;
+                        case 'n': token_start_ = pos_; literal_ = "null"; state_ = State::LITERAL; break;
+                        case 't': token_start_ = pos_; literal_ = "true"; state_ = State::LITERAL; break;
+                        case 'f': token_start_ = pos_; literal_ = "false"; state_ = State::LITERAL; break;
+                        default:
+                            if (std::isdigit(static_cast<unsigned char>(c)) || c == '-') {
+                                token_start_ = pos_++;
+                                state_ = State::NUMBER;
+                            } else if (std::isspace(static_cast<unsigned char>(c))) {
+                                pos_++;
+                            } else {
+                                errorOut = TokenizerError::UNEXPECTED_CHARACTER;
+                                error_offset_ = pos_;
+                                return 1;
+                            }
+                            break;
+                    }
+                    break;
+                }
+                case State::STRING: {
+                    // The whole string stays in the buffer, so escapes can be
+                    // checked backwards from every candidate quote
+                    const void* quote = std::memchr(data + pos_, '"', size - pos_);
+                    if (!quote) {
+                        pos_ = size;
+                        break;
+                    }
+                    const size_t end = static_cast<size_t>(static_cast<const char*>(quote) - data);
+                    size_t backslashes = 0;
+                    while (end - backslashes > token_start_ && data[end - backslashes - 1] == '\\') {
+                        backslashes++;
+                    }
+                    pos_ = end + 1;
+                    if (backslashes % 2 == 0) {
+                        push(TokenType::TOKEN_STRING, token_start_, end - token_start_);
+                        state_ = State::VALUE;
+                    }
+                    break;
+                }
+                case State::NUMBER: {
+                    while (pos_ < size) {
+                        const char c = data[pos_];
+                        if (!(std::isdigit(static_cast<unsigned char>(c)) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')) {
+                            break;
+                        }
+                        pos_++;
+                    }
+                    if (pos_ < size) {
+                        push(TokenType::TOKEN_NUMBER, token_start_, pos_ - token_start_);
+                        state_ = State::VALUE;
+                    }
+                    break;
+                }
+                case State::LITERAL: {
+                    // Compare the bytes available so far, complete once all are there
+                    while (pos_ < size && pos_ - token_start_ < literal_.size()) {
+                        if (data[pos_] != literal_[pos_ - token_start_]) {
+                            errorOut = TokenizerError::UNEXPECTED_CHARACTER;
+                            error_offset_ = pos_;
+                            return 1;
+                        }
+                        pos_++;
+                    }
+                    if (pos_ - token_start_ == literal_.size()) {
+                        push(literal_ == "null" ? TokenType::TOKEN_NULL : TokenType::TOKEN_BOOLEAN, token_start_, literal_.size());
+                        state_ = State::VALUE;
+                    }
+                    break;
+                }
+            }
+        }
+        if (!final) {
+            return 0;
+        }
+        switch (state_) {
+            case State::NUMBER:
+                push(TokenType::TOKEN_NUMBER, token_start_, pos_ - token_start_);
+                state_ = State::VALUE;
+                return 0;
+            case State::STRING:
+                errorOut = TokenizerError::UNTERMINATED_STRING;
+                error_offset_ = token_start_ - 1;
+                return 1;
+            case State::LITERAL:
+                errorOut = TokenizerError::UNEXPECTED_CHARACTER;
+                error_offset_ = token_start_;
+                return 1;
+            default:
+                return 0;
+        }
+    }
+
+    void StreamTokenizer::takeTokens(std::vector<Token>& tokens, std::vector<size_t>& jumps) {
+        // The caller's vectors come back cleared, their capacity serves the next document
+        tokens.swap(tokens_);
+        jumps.swap(jumps_);
+        tokens_.clear();
+        jumps_.clear();
     }
 
     std::vector<Token> Tokenizer::getTokens(){
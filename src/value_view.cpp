@@ -0,0 +1,216 @@
+#include "value_view.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace lazyjson {
+
+namespace {
+
+    inline bool isContainer(TokenType type) {
+        return type == TokenType::TOKEN_OBJECT_START || type == TokenType::TOKEN_ARRAY_START;
+    }
+
+    // Token after the value starting at `index`, past its separating comma.
+    // Never beyond <EOF>: the parser accepts some unbalanced documents
+    inline size_t nextSibling(const Parser& parser, size_t index) {
+        const size_t last = parser.getTokens().size() - 1;
+        if (index >= last) {
+            return last;
+        }
+        const size_t next = parser.valueEnd(index) + 1;
+        if (next >= last) {
+            return last;
+        }
+        return parser.getTokens()[next].type == TokenType::TOKEN_COMMA ? next + 1 : next;
+    }
+
+    // Compares a key as stored in the tape (escaped) with a plain key
+    bool keyEquals(std::string_view escaped, std::string_view key) {
+        if (escaped.find('\\') == std::string_view::npos) {
+            return escaped == key;
+        }
+        std::string decoded;
+        return unescapeString(escaped, decoded) && decoded == key;
+    }
+
+    [[noreturn]] void mismatch(const char* expected) {
+        throw std::runtime_error(std::string("ValueView: value is not ") + expected);
+    }
+
+} // namespace
+
+ValueView::ValueView(const Parser& parser) {
+    if (parser.getTokens().size() >= 3) {
+        parser_ = &parser;
+        index_ = 1;
+    }
+}
+
+const Token& ValueView::token() const {
+    return parser_->getTokens()[index_];
+}
+
+ElementType ValueView::type() const {
+    if (!parser_) {
+        return ElementType::UNDEFINED;
+    }
+    switch (token().type) {
+        case TokenType::TOKEN_NULL: return ElementType::NULL_VALUE;
+        case TokenType::TOKEN_BOOLEAN: return ElementType::BOOLEAN;
+        case TokenType::TOKEN_NUMBER: return ElementType::NUMBER;
+        case TokenType::TOKEN_STRING: return ElementType::STRING;
+        case TokenType::TOKEN_OBJECT_START: return ElementType::OBJECT;
+        case TokenType::TOKEN_ARRAY_START: return ElementType::ARRAY;
+        default: return ElementType::UNDEFINED;
+    }
+}
+
+bool ValueView::asBoolean() const {
+    if (!isBoolean()) mismatch("a boolean");
+    return token().value == "true";
+}
+
+double ValueView::asNumber() const {
+    if (!isNumber()) mismatch("a number");
+    const std::string_view text = token().value;
+    double value = 0;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (result.ec != std::errc() || result.ptr != text.data() + text.size()) {
+        value = std::strtod(std::string(text).c_str(), nullptr);
+    }
+    return value;
+}
+
+int64_t ValueView::asInt64() const {
+    if (!isNumber()) mismatch("a number");
+    const std::string_view text = token().value;
+    int64_t value = 0;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (result.ec == std::errc() && result.ptr == text.data() + text.size()) {
+        return value;
+    }
+    // Fraction or exponent notation: truncated like a cast, when the result fits
+    // (the conversion is undefined otherwise); [-2^63, 2^63) is exact in a double
+    const double number = asNumber();
+    if (!(number >= -9223372036854775808.0 && number < 9223372036854775808.0)) {
+        mismatch("a number in the int64 range");
+    }
+    return static_cast<int64_t>(number);
+}
+
+std::string_view ValueView::asRawString() const {
+    if (!isString()) mismatch("a string");
+    return token().value;
+}
+
+std::string ValueView::asString() const {
+    const std::string_view escaped = asRawString();
+    if (escaped.find('\\') == std::string_view::npos) {
+        return std::string(escaped);
+    }
+    std::string decoded;
+    if (!unescapeString(escaped, decoded)) {
+        throw std::runtime_error("ValueView: invalid escape sequence");
+    }
+    return decoded;
+}
+
+std::string_view ValueView::raw() const {
+    if (!parser_) {
+        return {};
+    }
+    const auto& tokens = parser_->getTokens();
+    const Token& first = tokens[index_];
+    const Token& last = tokens[parser_->valueEnd(index_)];
+    const char* begin = first.value.data();
+    const char* end = last.value.data() + last.value.size();
+    if (first.type == TokenType::TOKEN_STRING) {
+        begin--;
+        end++;
+    }
+    return std::string_view(begin, static_cast<size_t>(end - begin));
+}
+
+std::string_view ValueView::key() const {
+    if (!parser_ || index_ < 2) {
+        return {};
+    }
+    const auto& tokens = parser_->getTokens();
+    return tokens[index_ - 1].type == TokenType::TOKEN_COLON ? tokens[index_ - 2].value : std::string_view{};
+}
+
+ValueView ValueView::operator[](std::string_view key) const {
+    if (!parser_ || token().type != TokenType::TOKEN_OBJECT_START) {
+        return {};
+    }
+    const auto& tokens = parser_->getTokens();
+    size_t i = index_ + 1;
+    while (tokens[i].type == TokenType::TOKEN_STRING && i + 2 < tokens.size() - 1) {
+        if (keyEquals(tokens[i].value, key)) {
+            return ValueView(*parser_, i + 2);
+        }
+        i = nextSibling(*parser_, i + 2);
+    }
+    return {};
+}
+
+ValueView ValueView::operator[](size_t index) const {
+    if (!parser_ || token().type != TokenType::TOKEN_ARRAY_START) {
+        return {};
+    }
+    const auto& tokens = parser_->getTokens();
+    size_t i = index_ + 1;
+    // A '}' or <EOF> before the ']' only occurs in an unbalanced document
+    for (size_t position = 0; tokens[i].type != TokenType::TOKEN_ARRAY_END
+            && tokens[i].type != TokenType::TOKEN_OBJECT_END && tokens[i].type != TokenType::TOKEN_EOF; position++) {
+        if (position == index) {
+            return ValueView(*parser_, i);
+        }
+        i = nextSibling(*parser_, i);
+    }
+    return {};
+}
+
+size_t ValueView::size() const {
+    size_t count = 0;
+    for (auto it = begin(), last = end(); it != last; ++it) {
+        count++;
+    }
+    return count;
+}
+
+ValueView::Iterator ValueView::begin() const {
+    if (!parser_ || !isContainer(token().type)) {
+        return {};
+    }
+    return Iterator(parser_, index_ + 1, endIndex(), token().type == TokenType::TOKEN_OBJECT_START);
+}
+
+ValueView::Iterator ValueView::end() const {
+    if (!parser_ || !isContainer(token().type)) {
+        return {};
+    }
+    const size_t last = endIndex();
+    return Iterator(parser_, last, last, token().type == TokenType::TOKEN_OBJECT_START);
+}
+
+size_t ValueView::endIndex() const {
+    const size_t last = parser_->valueEnd(index_);
+    // A container that is never closed runs to <EOF>
+    return last == index_ ? parser_->getTokens().size() - 1 : last;
+}
+
+ValueView ValueView::Iterator::operator*() const {
+    return ValueView(*parser_, object_ ? std::min(index_ + 2, end_) : index_);
+}
+
+ValueView::Iterator& ValueView::Iterator::operator++() {
+    // Stop at the closing bracket even when a malformed member would step over it
+    index_ = std::min(nextSibling(*parser_, object_ ? index_ + 2 : index_), end_);
+    return *this;
+}
+
+} // namespace lazyjson
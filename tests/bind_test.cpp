@@ -0,0 +1,79 @@
+#include "bind.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Returns the number of failed checks (ctest fails on a non zero exit code)
+
+namespace test {
+
+    struct Numbers {
+        uint8_t small = 0;
+        int32_t count = 0;
+        uint32_t size = 0;
+        float ratio = 0;
+        double value = 0;
+    };
+    LAZYJSON_BIND(Numbers, small, count, size, ratio, value)
+
+} // namespace test
+
+namespace {
+
+    int failures = 0;
+
+    // Binds `json`; `valid` tells whether it must succeed or raise a mismatch
+    test::Numbers bind(std::string json, bool valid) {
+        test::Numbers numbers;
+        lazyjson::Parser parser;
+        if (!parser.parse(json)) {
+            std::printf("FAIL parse %s\n", json.c_str());
+            failures++;
+            return numbers;
+        }
+        bool thrown = false;
+        try {
+            numbers = lazyjson::extract<test::Numbers>(parser);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        if (thrown == valid) {
+            std::printf("FAIL %s: expected %s\n", json.c_str(), valid ? "success" : "a mismatch");
+            failures++;
+        }
+        return numbers;
+    }
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::printf("FAIL %s\n", what);
+            failures++;
+        }
+    }
+
+} // namespace
+
+int main() {
+    // Integers: integral values of any notation that fit the member
+    const test::Numbers numbers = bind(R"({"small":255,"count":1e3,"size":2.0})", true);
+    check(numbers.small == 255 && numbers.count == 1000 && numbers.size == 2, "integer members");
+    bind(R"({"small":300})", false);
+    bind(R"({"small":-1})", false);
+    bind(R"({"size":-1})", false);
+    bind(R"({"count":1e20})", false);
+    bind(R"({"count":1.5})", false);
+    bind(R"({"count":-2147483648})", true);
+    bind(R"({"count":2147483648})", false);
+
+    // Floating point: outside the member's finite range is a mismatch, not a cast
+    bind(R"({"ratio":1e300})", false);
+    bind(R"({"ratio":-1e39})", false);
+    bind(R"({"value":1e400})", false);
+    const test::Numbers floats = bind(R"({"ratio":0.5,"value":1e300})", true);
+    check(floats.ratio == 0.5f && floats.value == 1e300, "floating point members");
+    const test::Numbers tiny = bind(R"({"ratio":1e-50,"value":1e-400})", true);
+    check(tiny.ratio == 0 && tiny.value == 0, "underflow rounds to zero");
+
+    if (failures == 0) std::printf("bind_test: ok\n");
+    return failures;
+}
@@ -0,0 +1,50 @@
+#include "canonical.hpp"
+#include <cstdio>
+#include <string>
+
+// Returns the number of failed checks (ctest fails on a non zero exit code)
+
+namespace {
+
+    int failures = 0;
+
+    // Equality and hash equality must agree with `equal`
+    void expect(std::string json_a, std::string json_b, bool equal) {
+        lazyjson::Parser a, b;
+        if (!a.parse(json_a) || !b.parse(json_b)) {
+            std::printf("FAIL parse %s / %s\n", json_a.c_str(), json_b.c_str());
+            failures++;
+            return;
+        }
+        if (lazyjson::canonicalEqual(a, b) != equal) {
+            std::printf("FAIL canonicalEqual %s / %s: expected %d\n", json_a.c_str(), json_b.c_str(), equal);
+            failures++;
+        }
+        if ((lazyjson::canonicalHash(a) == lazyjson::canonicalHash(b)) != equal) {
+            std::printf("FAIL canonicalHash %s / %s: expected %s hashes\n", json_a.c_str(), json_b.c_str(),
+                        equal ? "equal" : "different");
+            failures++;
+        }
+    }
+
+} // namespace
+
+int main() {
+    // Distinct 64 bit IDs that round to the same double
+    expect(R"({"id":9007199254740993})", R"({"id":9007199254740992})", false);
+    expect(R"({"id":18446744073709551617})", R"({"id":18446744073709551616})", false);
+    expect(R"({"id":-9223372036854775807})", R"({"id":-9223372036854775806})", false);
+    expect(R"({"id":9007199254740993})", R"({"id":9007199254740992.5})", false);
+
+    // Same number, other spelling
+    expect(R"({"id":9007199254740993})", R"({"id":9007199254740993.0})", true);
+    expect(R"([1,100,120,0,0.5,1.5e300])", R"([1.0,1e2,1.20e2,-0,5e-1,15e299])", true);
+    expect(R"([0.1])", R"([0.10])", true);
+    expect(R"([0.1])", R"([0.2])", false);
+
+    // Member order and escapes
+    expect(R"({"a":1,"b":"A"})", R"({"b":"\u0041","a":1})", true);
+
+    if (failures == 0) std::printf("canonical_test: ok\n");
+    return failures;
+}
@@ -0,0 +1,44 @@
+#include "diff.hpp"
+#include <cstdio>
+#include <string>
+
+// Returns the number of failed checks (ctest fails on a non zero exit code)
+
+namespace {
+
+    int failures = 0;
+
+    void expect(std::string from_json, std::string to_json, const char* patch) {
+        lazyjson::Parser from, to;
+        if (!from.parse(from_json) || !to.parse(to_json)) {
+            std::printf("FAIL parse %s / %s\n", from_json.c_str(), to_json.c_str());
+            failures++;
+            return;
+        }
+        const std::string result = lazyjson::toJsonPatch(lazyjson::diff(from, to));
+        if (result != patch) {
+            std::printf("FAIL %s -> %s: expected %s, got %s\n", from_json.c_str(), to_json.c_str(), patch, result.c_str());
+            failures++;
+        }
+    }
+
+} // namespace
+
+int main() {
+    // Integers compare exactly, beyond the 53 bits of a double
+    expect(R"({"id":9007199254740993})", R"({"id":9007199254740992})",
+           R"([{"op":"replace","path":"/id","value":9007199254740992}])");
+    expect(R"([18446744073709551617])", R"([18446744073709551616])",
+           R"([{"op":"replace","path":"/0","value":18446744073709551616}])");
+    expect(R"([9007199254740993])", R"([9007199254740993.0])", "[]");
+    expect(R"([9007199254740993])", R"([9007199254740992.5])",
+           R"([{"op":"replace","path":"/0","value":9007199254740992.5}])");
+
+    // Same number, other spelling
+    expect(R"([1,100,-0,120,0.5])", R"([1.0,1e2,0,1.20e2,5e-1])", "[]");
+    expect(R"([0.1])", R"([0.10])", "[]");
+    expect(R"([1.5])", R"([1.25])", R"([{"op":"replace","path":"/0","value":1.25}])");
+
+    if (failures == 0) std::printf("diff_test: ok\n");
+    return failures;
+}
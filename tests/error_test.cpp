@@ -0,0 +1,90 @@
+#include "parser.hpp"
+#include "path.hpp"
+#include "value_view.hpp"
+#include <cstdio>
+#include <string>
+
+// Returns the number of failed checks (ctest fails on a non zero exit code)
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const std::string& what) {
+        if (!condition) {
+            std::printf("FAIL %s\n", what.c_str());
+            failures++;
+        }
+    }
+
+    bool is(const lazyjson::Error& error, lazyjson::ErrorKind kind, size_t offset) {
+        return error.kind == kind && error.offset == offset;
+    }
+
+    // Offsets:    0    5    10        19  23
+    const std::string document = R"({"a":{"b":[10,20]},"s":"x"})";
+
+    // get() returns 1 and lastError() says why, nothing is thrown
+    void get() {
+        lazyjson::Parser parser;
+        lazyjson::ElementPtr element;
+        check(parser.parse(document), "parse");
+        check(parser.get("a.c", element) == 1
+              && is(parser.lastError(), lazyjson::ErrorKind::KEY_NOT_FOUND, 5), "get missing key");
+        check(parser.get("a.b[5]", element) == 1
+              && is(parser.lastError(), lazyjson::ErrorKind::KEY_NOT_FOUND, 10), "get missing index");
+        check(parser.get("a.b[1", element) == 1
+              && is(parser.lastError(), lazyjson::ErrorKind::INVALID_PATH, 10), "get unterminated '['");
+        check(parser.get(lazyjson::Path("a.x"), element) == 1
+              && is(parser.lastError(), lazyjson::ErrorKind::KEY_NOT_FOUND, 5), "get Path missing key");
+        // A failed lookup leaves the document usable
+        check(parser.get("a.b[1]", element) == 0 && element->asNumber() == 20, "get after a failure");
+    }
+
+    // find() returns the error in its Expected
+    void find() {
+        lazyjson::Parser parser;
+        check(parser.parse(document), "parse");
+        auto result = parser.find("a.c");
+        check(!result && is(result.error(), lazyjson::ErrorKind::KEY_NOT_FOUND, 5), "find missing key");
+        result = parser.find("a.b[0");
+        check(!result && is(result.error(), lazyjson::ErrorKind::INVALID_PATH, 10), "find unterminated '['");
+        result = parser.find("s.x");
+        check(!result && is(result.error(), lazyjson::ErrorKind::NOT_A_CONTAINER, 23), "find through a scalar");
+        result = parser.find(lazyjson::Path("a.b[0].c"));
+        check(!result && is(result.error(), lazyjson::ErrorKind::NOT_A_CONTAINER, 11), "find Path through a scalar");
+        result = parser.find(lazyjson::Path("a.b[2]"));
+        check(!result && is(result.error(), lazyjson::ErrorKind::KEY_NOT_FOUND, 10), "find Path missing index");
+        check(is(parser.lastError(), lazyjson::ErrorKind::KEY_NOT_FOUND, 10), "find sets lastError()");
+        result = parser.find("a.b[1]");
+        check(result && result->asNumber() == 20 && !result.error(), "find after a failure");
+
+        lazyjson::Parser empty;
+        check(!empty.find("a") && empty.find("a").error().kind == lazyjson::ErrorKind::UNEXPECTED_END, "find without a document");
+    }
+
+    // parse() returns false with the kind and the offset where it stopped
+    void parse() {
+        lazyjson::Parser parser;
+        check(!parser.parse(std::string_view("[1,2"))
+              && is(parser.lastError(), lazyjson::ErrorKind::UNEXPECTED_END, 4), "unterminated '['");
+        check(!parser.parse(std::string_view(R"({"a":)"))
+              && is(parser.lastError(), lazyjson::ErrorKind::UNEXPECTED_END, 5), "input ending before a value");
+        check(!parser.parse(std::string_view(R"({"a":"b)"))
+              && is(parser.lastError(), lazyjson::ErrorKind::UNTERMINATED_STRING, 5), "unterminated string");
+        check(!parser.parse(std::string_view(R"({"a" 1})"))
+              && parser.lastError().kind == lazyjson::ErrorKind::UNEXPECTED_TOKEN, "missing ':'");
+        // A successful parse clears the previous error
+        check(parser.parse(std::string_view("[1]")) && !parser.lastError(), "parse after a failure");
+    }
+
+} // namespace
+
+int main() {
+    get();
+    find();
+    parse();
+
+    if (failures == 0) std::printf("error_test: ok\n");
+    return failures;
+}
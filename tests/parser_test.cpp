@@ -0,0 +1,57 @@
+#include "parser.hpp"
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+// Returns the number of failed checks (ctest fails on a non zero exit code)
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::printf("FAIL %s\n", what);
+            failures++;
+        }
+    }
+
+    double number(lazyjson::Parser& parser, const char* path) {
+        lazyjson::ElementPtr element;
+        if (parser.get(path, element) != 0 || !element->isNumber()) return -1;
+        return element->asNumber();
+    }
+
+    template<typename T, typename = void>
+    struct CanParse : std::false_type {};
+    template<typename T>
+    struct CanParse<T, std::void_t<decltype(std::declval<lazyjson::Parser&>().parse(std::declval<T>()))>> : std::true_type {};
+
+    // Tokens view the input: temporaries are refused at compile time
+    static_assert(CanParse<std::string&>::value, "parse(std::string&)");
+    static_assert(CanParse<std::string_view>::value, "parse(std::string_view)");
+    static_assert(CanParse<const char*>::value, "parse(const char*)");
+    static_assert(!CanParse<std::string>::value, "parse(std::string&&) must not compile");
+    static_assert(!CanParse<std::string&&>::value, "parse(std::string&&) must not compile");
+
+    // Nested arrays are skipped whole: a '[' starting an element must not count twice
+    void arraysOfArrays() {
+        std::string json = R"({"m":[[1,2],[3,[4,[5]]],[],6],"n":7})";
+        lazyjson::Parser parser;
+        check(parser.parse(json), "parse");
+        check(number(parser, "m[0][1]") == 2, "m[0][1]");
+        check(number(parser, "m[1][1][1][0]") == 5, "m[1][1][1][0]");
+        check(number(parser, "m[3]") == 6, "element after nested arrays");
+        check(number(parser, "n") == 7, "member after nested arrays");
+        lazyjson::ElementPtr element;
+        check(parser.get("m[4]", element) != 0, "no element past the end");
+    }
+
+} // namespace
+
+int main() {
+    arraysOfArrays();
+
+    if (failures == 0) std::printf("parser_test: ok\n");
+    return failures;
+}
@@ -0,0 +1,61 @@
+#include "schema.hpp"
+#include <cstdio>
+#include <string>
+
+// Returns the number of failed checks (ctest fails on a non zero exit code)
+
+namespace {
+
+    int failures = 0;
+
+    void expect(const char* schema_text, const char* json, bool valid) {
+        lazyjson::Schema schema;
+        std::string message;
+        if (schema.compile(schema_text, message) != 0) {
+            std::printf("FAIL compile %s: %s\n", schema_text, message.c_str());
+            failures++;
+            return;
+        }
+        lazyjson::ValidationError error;
+        if (schema.validate(std::string_view(json), error) != valid) {
+            std::printf("FAIL %s with %s: expected %s (%s)\n", schema_text, json,
+                        valid ? "valid" : "invalid", error.message.c_str());
+            failures++;
+        }
+    }
+
+} // namespace
+
+int main() {
+    // Inclusive and exclusive bounds together: both apply, in any keyword order
+    expect(R"({"minimum":10,"exclusiveMinimum":5})", "6", false);
+    expect(R"({"minimum":10,"exclusiveMinimum":5})", "10", true);
+    expect(R"({"exclusiveMinimum":5,"minimum":10})", "6", false);
+    expect(R"({"exclusiveMinimum":5,"minimum":0})", "1", false);
+    expect(R"({"exclusiveMinimum":5,"minimum":0})", "3", false);
+    expect(R"({"exclusiveMinimum":5,"minimum":0})", "5", false);
+    expect(R"({"exclusiveMinimum":5,"minimum":0})", "5.5", true);
+    expect(R"({"maximum":10,"exclusiveMaximum":20})", "15", false);
+    expect(R"({"maximum":10,"exclusiveMaximum":20})", "10", true);
+    expect(R"({"exclusiveMaximum":5,"maximum":10})", "7", false);
+    expect(R"({"exclusiveMaximum":5,"maximum":10})", "5", false);
+    expect(R"({"exclusiveMaximum":5,"maximum":10})", "4", true);
+    expect(R"({"minimum":0,"maximum":10})", "0", true);
+    expect(R"({"minimum":0,"maximum":10})", "10", true);
+    expect(R"({"minimum":0,"maximum":10})", "-1", false);
+    expect(R"({"minimum":0,"maximum":10})", "11", false);
+
+    // Draft 4: boolean exclusiveMinimum/exclusiveMaximum modify minimum/maximum
+    expect(R"({"minimum":5,"exclusiveMinimum":true})", "5", false);
+    expect(R"({"exclusiveMinimum":true,"minimum":5})", "5.1", true);
+    expect(R"({"minimum":5,"exclusiveMinimum":false})", "5", true);
+    expect(R"({"maximum":5,"exclusiveMaximum":true})", "5", false);
+    expect(R"({"maximum":5,"exclusiveMaximum":true})", "4", true);
+
+    // Bounds combined with integer
+    expect(R"({"type":"integer","exclusiveMinimum":0,"maximum":3})", "3", true);
+    expect(R"({"type":"integer","exclusiveMinimum":0,"maximum":3})", "0", false);
+
+    if (failures == 0) std::printf("schema_test: ok\n");
+    return failures;
+}
@@ -0,0 +1,58 @@
+#include "shape.hpp"
+#include <cstdio>
+#include <string>
+
+// Returns the number of failed checks (ctest fails on a non zero exit code)
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::printf("FAIL %s\n", what);
+            failures++;
+        }
+    }
+
+    std::shared_ptr<const lazyjson::Shape> intern(lazyjson::ShapeCache& cache, const std::vector<std::string_view>& keys) {
+        return cache.intern(keys, lazyjson::ShapeCache::hashKeys(keys));
+    }
+
+    void reuse() {
+        lazyjson::ShapeCache cache;
+        const std::vector<std::string_view> keys = {"id", "name", "tags"};
+        auto first = intern(cache, keys);
+        check(first && first->size() == 3 && first->slot("name") == 1, "shape created");
+        check(intern(cache, keys) == first, "same layout, same shape");
+        check(intern(cache, {"name", "id", "tags"}) != first, "order matters");
+        check(cache.size() == 2 && cache.hits() == 1, "counters");
+    }
+
+    // Layouts that cannot be cached never reach the interner
+    void rejected() {
+        auto interner = std::make_shared<lazyjson::KeyInterner>(16);
+        lazyjson::ShapeCache cache(1, 64, interner);
+        for (int i = 0; i < 100; i++) {
+            check(intern(cache, {"a", "b", "a"}) == nullptr, "duplicate keys refused");
+        }
+        check(cache.size() == 0 && interner->size() == 0, "duplicate keys not interned");
+
+        check(intern(cache, {"x", "y"}) != nullptr, "first shape");
+        for (int i = 0; i < 100; i++) {
+            const std::string key = "k" + std::to_string(i);
+            check(intern(cache, {key, "z"}) == nullptr, "full cache refuses new layouts");
+        }
+        check(cache.size() == 1 && interner->size() == 2, "full cache interns nothing more");
+        check(intern(cache, {"x", "y"}) != nullptr, "cached shape still found");
+    }
+
+} // namespace
+
+int main() {
+    reuse();
+    rejected();
+
+    if (failures == 0) std::printf("shape_test: ok\n");
+    return failures;
+}
@@ -0,0 +1,198 @@
+#include "parser.hpp"
+#include "sidecar.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// Returns the number of failed checks (ctest fails on a non zero exit code)
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::printf("FAIL %s\n", what);
+            failures++;
+        }
+    }
+
+    void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    constexpr size_t align8(size_t size) { return (size + 7) & ~size_t(7); }
+
+    // Byte offset of jump[index] in a version 1 tape of `count` tokens
+    size_t jumpOffset(size_t count, size_t index) {
+        return align8(sizeof(lazyjson::TapeHeader)) + 2 * align8(count * sizeof(uint32_t)) + index * sizeof(uint32_t);
+    }
+
+    // Overwrite jump[index] of a version 1 tape
+    void corruptJump(const std::string& tape_path, size_t index, uint32_t value) {
+        std::string tape = readFile(tape_path);
+        lazyjson::TapeHeader header;
+        std::memcpy(&header, tape.data(), sizeof(header));
+        std::memcpy(&tape[jumpOffset(header.token_count, index)], &value, sizeof(value));
+        writeFile(tape_path, tape);
+    }
+
+    // save + read gives back the tokens and the jump table of the parse
+    void roundTrip() {
+        const std::string tape_path = "sidecar_test_round_trip.tape";
+        std::string json = R"({"a":[1,[2,{"b":"x\"y"}]],"c":{},"d":[],"e":-1.5e3,"f":true,"g":null})";
+        lazyjson::Parser parser;
+        check(parser.parse(json), "parse");
+        check(parser.saveTape(tape_path), "saveTape");
+
+        lazyjson::TapeHeader header;
+        const std::string tape = readFile(tape_path);
+        std::memcpy(&header, tape.data(), sizeof(header));
+        check(header.version == 1, "small source uses the 32 bit layout");
+        check(header.token_count == parser.getTokens().size(), "header token count");
+
+        std::vector<lazyjson::Token> tokens;
+        std::vector<size_t> jumps;
+        lazyjson::TapeError error = lazyjson::TapeError::NONE;
+        check(lazyjson::readTape(tape_path, json, lazyjson::TapeValidation::CONTENT_HASH, tokens, jumps, error) == 0,
+              "readTape");
+        std::vector<size_t> expected_jumps;
+        lazyjson::computeJumps(parser.getTokens(), expected_jumps);
+        check(jumps == expected_jumps, "jump table");
+        bool same = tokens.size() == parser.getTokens().size();
+        for (size_t i = 0; same && i < tokens.size(); i++) {
+            same = tokens[i].type == parser.getTokens()[i].type && tokens[i].value == parser.getTokens()[i].value;
+        }
+        check(same, "tokens");
+        std::remove(tape_path.c_str());
+    }
+
+    // A sidecar is only trusted for its source; CONTENT_HASH also sees same size edits
+    void validation() {
+        const std::string tape_path = "sidecar_test_validation.tape";
+        std::string json = R"({"v":1})";
+        lazyjson::Parser parser;
+        parser.parse(json);
+        parser.saveTape(tape_path);
+
+        std::vector<lazyjson::Token> tokens;
+        std::vector<size_t> jumps;
+        lazyjson::TapeError error = lazyjson::TapeError::NONE;
+        const std::string edited = R"({"v":2})";
+        check(lazyjson::readTape(tape_path, edited, lazyjson::TapeValidation::CONTENT_HASH, tokens, jumps, error) != 0
+              && error == lazyjson::TapeError::SOURCE_MISMATCH, "CONTENT_HASH refuses an edited source");
+        check(lazyjson::readTape(tape_path, edited, lazyjson::TapeValidation::SIZE_ONLY, tokens, jumps, error) == 0,
+              "SIZE_ONLY accepts a source of the same size");
+        const std::string longer = R"({"v":10})";
+        check(lazyjson::readTape(tape_path, longer, lazyjson::TapeValidation::SIZE_ONLY, tokens, jumps, error) != 0
+              && error == lazyjson::TapeError::SOURCE_MISMATCH, "SIZE_ONLY refuses another size");
+
+        std::string tape = readFile(tape_path);
+        tape[0] = 'X';
+        writeFile(tape_path, tape);
+        check(lazyjson::readTape(tape_path, json, lazyjson::TapeValidation::CONTENT_HASH, tokens, jumps, error) != 0
+              && error == lazyjson::TapeError::INVALID_FORMAT, "bad magic");
+        tape[0] = 'L';
+        writeFile(tape_path, tape.substr(0, tape.size() - 16));
+        check(lazyjson::readTape(tape_path, json, lazyjson::TapeValidation::CONTENT_HASH, tokens, jumps, error) != 0
+              && error == lazyjson::TapeError::INVALID_FORMAT, "truncated tape");
+        std::remove(tape_path.c_str());
+        check(lazyjson::readTape(tape_path, json, lazyjson::TapeValidation::CONTENT_HASH, tokens, jumps, error) != 0
+              && error == lazyjson::TapeError::IO_ERROR, "missing tape");
+    }
+
+    // load() writes the sidecar, reuses it, and replaces it once the file changed
+    void loadStale() {
+        const std::string json_path = "sidecar_test_stale.json";
+        const std::string tape_path = json_path + ".tape";
+        std::remove(tape_path.c_str());
+        writeFile(json_path, R"({"v":[1,[2]],"w":"a"})");
+        lazyjson::ElementPtr element;
+        {
+            lazyjson::Parser parser;
+            check(parser.load(json_path, tape_path), "first load");
+            check(readFile(tape_path).size() > sizeof(lazyjson::TapeHeader), "first load writes the sidecar");
+            check(parser.get("v[1][0]", element) == 0 && element->asNumber() == 2, "value on first load");
+        }
+        {
+            lazyjson::Parser parser;
+            check(parser.load(json_path, tape_path), "load from the sidecar");
+            check(parser.get("w", element) == 0 && element->asString() == "a", "value from the sidecar");
+        }
+        // Same size, other content and structure: the stale tape is replaced
+        writeFile(json_path, R"({"v":[1,2,3,4],"w":"b"})");
+        {
+            lazyjson::Parser parser;
+            check(parser.load(json_path, tape_path), "load with a stale sidecar");
+            check(parser.get("v[3]", element) == 0 && element->asNumber() == 4, "value after a stale sidecar");
+            check(parser.get("w", element) == 0 && element->asString() == "b", "string after a stale sidecar");
+        }
+        std::vector<lazyjson::Token> tokens;
+        std::vector<size_t> jumps;
+        lazyjson::TapeError error = lazyjson::TapeError::NONE;
+        check(lazyjson::readTape(tape_path, readFile(json_path), lazyjson::TapeValidation::CONTENT_HASH, tokens, jumps, error) == 0,
+              "stale sidecar refreshed");
+        std::remove(json_path.c_str());
+        std::remove(tape_path.c_str());
+    }
+
+    // A corrupted jump table is refused, and load() falls back to tokenizing
+    void corruptedJumps() {
+        const std::string json_path = "sidecar_test_corrupt.json";
+        const std::string tape_path = json_path + ".tape";
+        const std::string json = R"({"a":[1,[2]],"b":2})";
+        writeFile(json_path, json);
+        std::remove(tape_path.c_str());
+        {
+            lazyjson::Parser parser;
+            check(parser.load(json_path, tape_path), "load writes the sidecar");
+        }
+
+        // <SOF> { "a" : [ 1 , [ 2 ] ] , "b" : 2 } <EOF>: jump[7] is the inner '['
+        const std::pair<size_t, uint32_t> corruptions[] = {
+            {7, 4},    // backwards, onto another '['
+            {7, 7},    // onto itself
+            {7, 10},   // onto the wrong ']'
+            {4, 15},   // onto a '}'
+            {9, 4},    // closing bracket not pointing back
+            {5, 9},    // scalar with a jump
+        };
+        for (const auto& [index, value] : corruptions) {
+            lazyjson::Parser writer;
+            writer.load(json_path, tape_path);
+            writer.saveTape(tape_path);
+            corruptJump(tape_path, index, value);
+
+            std::vector<lazyjson::Token> tokens;
+            std::vector<size_t> jumps;
+            lazyjson::TapeError error = lazyjson::TapeError::NONE;
+            const int result = lazyjson::readTape(tape_path, json, lazyjson::TapeValidation::CONTENT_HASH, tokens, jumps, error);
+            check(result != 0 && error == lazyjson::TapeError::INVALID_FORMAT, "corrupted jump refused");
+
+            corruptJump(tape_path, index, value);
+            lazyjson::Parser parser;
+            lazyjson::ElementPtr element;
+            check(parser.load(json_path, tape_path), "load with a corrupted sidecar");
+            check(parser.get("b", element) == 0 && element->asNumber() == 2, "value after a corrupted sidecar");
+        }
+        std::remove(json_path.c_str());
+        std::remove(tape_path.c_str());
+    }
+
+} // namespace
+
+int main() {
+    roundTrip();
+    validation();
+    loadStale();
+    corruptedJumps();
+
+    if (failures == 0) std::printf("sidecar_test: ok\n");
+    return failures;
+}
@@ -0,0 +1,113 @@
+#include "parser.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Returns the number of failed checks (ctest fails on a non zero exit code)
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const std::string& what) {
+        if (!condition) {
+            std::printf("FAIL %s\n", what.c_str());
+            failures++;
+        }
+    }
+
+    // Type and text of every token
+    std::vector<std::pair<lazyjson::TokenType, std::string>> tape(const lazyjson::Parser& parser) {
+        std::vector<std::pair<lazyjson::TokenType, std::string>> out;
+        for (const auto& token : parser.getTokens()) {
+            out.emplace_back(token.type, std::string(token.value));
+        }
+        return out;
+    }
+
+    // feed() in chunks of `chunk` bytes then finish() must give the tape of parse()
+    void compare(const std::string& document, size_t chunk) {
+        std::string source = document;
+        lazyjson::Parser reference;
+        check(reference.parse(source), "parse " + document.substr(0, 40));
+        std::vector<size_t> jumps;
+        lazyjson::computeJumps(reference.getTokens(), jumps);
+
+        lazyjson::Parser parser;
+        bool fed = true;
+        for (size_t pos = 0; pos < document.size(); pos += chunk) {
+            fed = parser.feed(std::string_view(document).substr(pos, chunk)) && fed;
+        }
+        const std::string what = document.substr(0, 40) + " in chunks of " + std::to_string(chunk);
+        check(fed && parser.finish(), "finish " + what);
+        check(tape(parser) == tape(reference), "tokens " + what);
+        check(parser.getTokenJumps() == jumps, "jumps " + what);
+        // Every view points into the final buffer (the one <EOF> ends), at the offset
+        // parse() found: views left in a buffer replaced by grow() would not
+        const char* base = parser.getTokens().back().value.data() - document.size();
+        bool offsets = parser.getTokens().size() == reference.getTokens().size();
+        for (size_t i = 0; offsets && i < parser.getTokens().size(); i++) {
+            offsets = parser.getTokens()[i].value.data() - base == reference.getTokens()[i].value.data() - source.data();
+        }
+        check(offsets, "offsets " + what);
+        check(parser.dump() == reference.dump(), "document " + what);
+    }
+
+    void chunkSizes() {
+        const std::string documents[] = {
+            R"({"s":"plain","e":"q\"uote","b":"a\\","u":"é😀","n":-12.5e+3,"t":true,"f":false,"z":null})",
+            R"([1,[22,[333,{"k":[]}]],{},"",0,-0.0,1E-2])",
+            R"(  {"a" : [ true , false , null ] , "b\\\"" : 12345678901234567890 }  )",
+            "4096",
+            R"("just a string")",
+        };
+        for (const auto& document : documents) {
+            for (size_t chunk = 1; chunk <= document.size(); chunk++) {
+                compare(document, chunk);
+            }
+        }
+    }
+
+    // Many small chunks grow the buffer several times: earlier tokens are rebased
+    void bufferGrowth() {
+        std::string document = "[";
+        for (int i = 0; i < 2000; i++) {
+            document += R"({"id":)" + std::to_string(i) + R"(,"name":"item\")" + std::to_string(i) + R"(","ok":true},)";
+        }
+        document += "null]";
+        for (size_t chunk : {size_t(1), size_t(3), size_t(7), size_t(100), size_t(4095), size_t(4097), document.size()}) {
+            compare(document, chunk);
+        }
+    }
+
+    void errors() {
+        lazyjson::Parser parser;
+        check(parser.feed(R"({"a":"unterminated)") && !parser.finish()
+              && parser.lastError().kind == lazyjson::ErrorKind::UNTERMINATED_STRING, "unterminated string");
+        check(parser.feed("[tr") && !parser.feed("ue,nul!]"), "bad literal across chunks");
+        check(parser.lastError().kind == lazyjson::ErrorKind::UNEXPECTED_CHARACTER, "bad literal error kind");
+        // The next feed() after finish() starts a new document
+        check(parser.feed("[1,") && parser.feed("2]") && parser.finish() && parser.getTokens().size() == 7, "new document");
+    }
+
+    // An escaped backslash right before the closing quote ends the string
+    void escapedBackslash() {
+        std::string json = R"({"a":"a\\","b":1})";
+        lazyjson::Parser parser;
+        lazyjson::ElementPtr element;
+        check(parser.parse(json), "parse escaped backslash");
+        check(parser.get("a", element) == 0 && element->isString() && element->asString() == R"(a\\)", "string ending in a backslash");
+        check(parser.get("b", element) == 0 && element->isNumber() && element->asNumber() == 1, "member after it");
+    }
+
+} // namespace
+
+int main() {
+    chunkSizes();
+    bufferGrowth();
+    errors();
+    escapedBackslash();
+
+    if (failures == 0) std::printf("stream_test: ok\n");
+    return failures;
+}
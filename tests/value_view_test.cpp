@@ -0,0 +1,69 @@
+#include "value_view.hpp"
+#include <cstdio>
+#include <string>
+
+// Returns the number of failed checks (ctest fails on a non zero exit code)
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::printf("FAIL %s\n", what);
+            failures++;
+        }
+    }
+
+    void navigation() {
+        std::string json = R"({"a":{"b":[1,[2,3],{"c":4}]},"d":"x"})";
+        lazyjson::Parser parser;
+        check(parser.parse(json), "parse");
+        lazyjson::ValueView root(parser);
+        check(root["a"]["b"][2]["c"].asInt64() == 4, "nested lookup");
+        check(root["a"]["b"][1][1].asInt64() == 3, "element of a nested array");
+        check(!root["a"]["b"][3].valid(), "index past the end");
+        check(root["a"]["b"].size() == 3, "array size");
+        check(root.size() == 2, "object size");
+        check(root["d"].asString() == "x", "member after a nested object");
+    }
+
+    // Unbalanced documents the parser lets through: navigation stays on the tape
+    void unbalanced() {
+        const char* documents[] = {
+            R"({"a":{"b":[1,2}})",
+            R"({"a":{"b":[1,2}},"c":[3}})",
+        };
+        for (const char* document : documents) {
+            std::string json = document;
+            lazyjson::Parser parser;
+            check(parser.parse(json), document);
+            const size_t tokens = parser.getTokens().size();
+            lazyjson::ValueView root(parser);
+            for (size_t i = 0; i < 8; i++) {
+                for (lazyjson::ValueView view : {root[i], root["a"][i], root["a"]["b"][i], root["c"][i], root["a"]["z"]}) {
+                    check(!view.valid() || view.tokenIndex() < tokens - 1, document);
+                    view.type();
+                }
+            }
+            for (lazyjson::ValueView container : {root, root["a"], root["a"]["b"], root["c"]}) {
+                size_t count = 0;
+                for (auto item : container) {
+                    check(item.tokenIndex() < tokens, document);
+                    item.type();
+                    if (++count > tokens) break;
+                }
+                check(count <= tokens && container.size() <= tokens, document);
+            }
+        }
+    }
+
+} // namespace
+
+int main() {
+    navigation();
+    unbalanced();
+
+    if (failures == 0) std::printf("value_view_test: ok\n");
+    return failures;
+}